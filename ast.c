@@ -0,0 +1,210 @@
+/* ast.c
+ *
+ * Abstract syntax tree.
+ *
+ * The parser converts the tokens of a module into a tree of nodes. Every
+ * statement, block and expression is represented by a node (see ast.h).
+ * The tree is only needed to compile the module, afterwards it is freed
+ * with tree_free().
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <assert.h>
+#include <stdlib.h>
+
+#include "reader.h"
+#include "error.h"
+#include "ast.h"
+
+static void nodelist_free(NodeList *list);
+
+
+/* Nodes are allocated from large blocks instead of one by one, as a
+ * module can contain millions of nodes. There is only one tree at a time:
+ * a module is compiled before the next one is parsed.
+ */
+#define BLOCKSIZE	65536		/* number of bytes in a block */
+
+typedef struct block {
+	struct block *next;
+	size_t used;				/* number of bytes handed out */
+	double data[];				/* double for alignment */
+} Block;
+
+static Block *blocks = NULL;	/* block in use, followed by all full blocks */
+
+
+/* Create a new node.
+ *
+ * type     type of the node
+ * size     number of bytes required for the node struct
+ * return   pointer to new node, all fields except type and offset are zero
+ *
+ * The node is located at the current token of the module being parsed.
+ */
+Node *node_alloc(nodetype_t type, size_t size)
+{
+	Block *block;
+	Node *node;
+
+	assert(size >= sizeof(Node) && size <= BLOCKSIZE);
+
+	size = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+
+	if (blocks == NULL || blocks->used + size > BLOCKSIZE) {
+		if ((block = calloc(1, sizeof(Block) + BLOCKSIZE)) == NULL)
+			error(OutOfMemoryError);
+		block->next = blocks;
+		blocks = block;
+	}
+
+	node = (Node *)((char *)blocks->data + blocks->used);
+	blocks->used += size;
+
+	node->type = type;
+	node->offset = (unsigned int)(reader.pos - reader.current->code);
+
+	return node;
+}
+
+
+/* Add a node to the end of a list of nodes.
+ *
+ * list     list to add the node to
+ * node     node to add, may be NULL
+ */
+void nodelist_append(NodeList *list, Node *node)
+{
+	Node **item;
+
+	assert(list != NULL);
+
+	if ((item = realloc(list->item, (list->count + 1) * sizeof(Node *))) == NULL)
+		error(OutOfMemoryError);
+
+	list->item = item;
+	list->item[list->count++] = node;
+}
+
+
+/* Free the node lists of a node and all nodes below it.
+ *
+ * The value of a constant is not freed, it was moved to the constants of
+ * the bytecode. Names are interned so they are not freed either. A
+ * function definition is both a statement and an item in the function
+ * list of the module; its lists are only freed via the latter.
+ */
+static void release(Node *node)
+{
+	if (node == NULL)
+		return;
+
+	switch (node->type) {
+		case LISTEXPR_N:
+			nodelist_free(&((ListExprNode *)node)->element);
+			break;
+		case CALL_N:
+			nodelist_free(&((CallNode *)node)->argument);
+			break;
+		case INDEX_N:
+			release(((IndexNode *)node)->sequence);
+			release(((IndexNode *)node)->index);
+			break;
+		case SLICE_N:
+			release(((SliceNode *)node)->sequence);
+			release(((SliceNode *)node)->start);
+			release(((SliceNode *)node)->end);
+			break;
+		case METHOD_N:
+			release(((MethodNode *)node)->object);
+			nodelist_free(&((MethodNode *)node)->argument);
+			break;
+		case UNARY_N:
+			release(((UnaryNode *)node)->operand);
+			break;
+		case BINARY_N:
+			release(((BinaryNode *)node)->left);
+			release(((BinaryNode *)node)->right);
+			break;
+		case ASSIGN_N:
+			release(((AssignNode *)node)->target);
+			release(((AssignNode *)node)->value);
+			break;
+		case COMMA_N:
+			release(((CommaNode *)node)->left);
+			release(((CommaNode *)node)->right);
+			break;
+		case BLOCK_N:
+			nodelist_free(&((BlockNode *)node)->statement);
+			break;
+		case VARDECL_N:
+			nodelist_free(&((VarDeclNode *)node)->name);
+			nodelist_free(&((VarDeclNode *)node)->value);
+			break;
+		case FOR_N:
+			release(((ForNode *)node)->sequence);
+			release(((ForNode *)node)->body);
+			break;
+		case WHILE_N:
+		case DO_N:
+			release(((LoopNode *)node)->condition);
+			release(((LoopNode *)node)->body);
+			break;
+		case IF_N:
+			release(((IfNode *)node)->condition);
+			release(((IfNode *)node)->consequent);
+			release(((IfNode *)node)->alternative);
+			break;
+		case IMPORT_N:
+		case PRINT_N:
+		case RETURN_N:
+			nodelist_free(&((ListStmntNode *)node)->expression);
+			break;
+		case INPUT_N:
+			nodelist_free(&((InputNode *)node)->prompt);
+			nodelist_free(&((InputNode *)node)->name);
+			break;
+		case EXPRESSION_N:
+			release(((ExpressionNode *)node)->expression);
+			break;
+		case MODULE_N:
+			nodelist_free(&((ModuleNode *)node)->statement);
+			for (int i = 0; i < ((ModuleNode *)node)->function.count; i++) {
+				FuncDefNode *function = (FuncDefNode *)((ModuleNode *)node)->function.item[i];
+				nodelist_free(&function->parameter);
+				release(function->body);
+			}
+			free(((ModuleNode *)node)->function.item);
+			break;
+		default:  /* CONSTANT_N, NAME_N, FUNCDEF_N, PASS_N, BREAK_N, CONTINUE_N */
+			break;
+	}
+}
+
+
+/* Free all nodes in a list of nodes, and the list itself.
+ */
+static void nodelist_free(NodeList *list)
+{
+	for (int i = 0; i < list->count; i++)
+		release(list->item[i]);
+
+	free(list->item);
+}
+
+
+/* Free a syntax tree once it has been compiled.
+ *
+ * tree		module node at the root of the tree
+ */
+void tree_free(Node *tree)
+{
+	Block *block;
+
+	release(tree);
+
+	while ((block = blocks) != NULL) {
+		blocks = block->next;
+		free(block);
+	}
+}
@@ -0,0 +1,174 @@
+/* ast.h
+ *
+ * Abstract syntax tree.
+ *
+ * Every node starts with NODE_HEAD, in the same way every object starts
+ * with OBJ_HEAD. The type determines which struct a node actually is.
+ * Offset is the position in the module code where the node was found,
+ * and is used when reporting errors.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _AST_
+#define _AST_
+
+#include "scanner.h"
+#include "object.h"
+
+typedef enum {	CONSTANT_N, LISTEXPR_N, NAME_N, CALL_N, INDEX_N, SLICE_N,
+				METHOD_N, UNARY_N, BINARY_N, ASSIGN_N, COMMA_N, BLOCK_N,
+				VARDECL_N, FUNCDEF_N, FOR_N, WHILE_N, DO_N, IF_N, IMPORT_N,
+				PASS_N, PRINT_N, INPUT_N, RETURN_N, BREAK_N, CONTINUE_N,
+				EXPRESSION_N, MODULE_N } nodetype_t;
+
+typedef enum { INSERT_M, APPEND_M, REMOVE_M, LEN_M, UNKNOWN_M } method_t;
+
+#define NODE_HEAD	nodetype_t type;  \
+					unsigned int offset
+
+typedef struct node {
+	NODE_HEAD;
+} Node;
+
+typedef struct nodelist {
+	int count;
+	Node **item;
+} NodeList;
+
+typedef struct {				/* literal: 1  2.0  'c'  "abc" */
+	NODE_HEAD;
+	Object *value;
+} ConstantNode;
+
+typedef struct {				/* [ element, ... ] */
+	NODE_HEAD;
+	NodeList element;
+} ListExprNode;
+
+typedef struct {				/* identifier */
+	NODE_HEAD;
+	char *name;
+} NameNode;
+
+typedef struct {				/* identifier ( argument, ... ) */
+	NODE_HEAD;
+	char *name;
+	NodeList argument;
+} CallNode;
+
+typedef struct {				/* sequence [ index ] */
+	NODE_HEAD;
+	Node *sequence;
+	Node *index;
+} IndexNode;
+
+typedef struct {				/* sequence [ start : end ], start and end optional */
+	NODE_HEAD;
+	Node *sequence;
+	Node *start;
+	Node *end;
+} SliceNode;
+
+typedef struct {				/* object . method ( argument, ... ) */
+	NODE_HEAD;
+	Node *object;
+	method_t method;
+	char *name;
+	NodeList argument;
+} MethodNode;
+
+typedef struct {				/* operator operand */
+	NODE_HEAD;
+	token_t operator;
+	Node *operand;
+} UnaryNode;
+
+typedef struct {				/* left operator right */
+	NODE_HEAD;
+	token_t operator;
+	Node *left;
+	Node *right;
+} BinaryNode;
+
+typedef struct {				/* target operator value, operator is = += -= ... */
+	NODE_HEAD;
+	token_t operator;
+	Node *target;
+	Node *value;
+} AssignNode;
+
+typedef struct {				/* left , right */
+	NODE_HEAD;
+	Node *left;
+	Node *right;
+} CommaNode;
+
+typedef struct {				/* NEWLINE INDENT statement+ DEDENT */
+	NODE_HEAD;
+	NodeList statement;
+} BlockNode;
+
+typedef struct {				/* type name ( = value )?, ... */
+	NODE_HEAD;
+	objecttype_t vartype;
+	NodeList name;				/* NameNode's */
+	NodeList value;				/* initial value per name or NULL */
+} VarDeclNode;
+
+typedef struct {				/* def name ( parameter, ... ) block */
+	NODE_HEAD;
+	char *name;
+	NodeList parameter;			/* NameNode's */
+	Node *body;
+} FuncDefNode;
+
+typedef struct {				/* for name in sequence block */
+	NODE_HEAD;
+	char *name;
+	Node *sequence;
+	Node *body;
+} ForNode;
+
+typedef struct {				/* while condition block, do block while condition */
+	NODE_HEAD;
+	Node *condition;
+	Node *body;
+} LoopNode;
+
+typedef struct {				/* if condition block ( else block )? */
+	NODE_HEAD;
+	Node *condition;
+	Node *consequent;
+	Node *alternative;			/* NULL if there is no else */
+} IfNode;
+
+typedef struct {				/* import, print and return */
+	NODE_HEAD;
+	NodeList expression;
+	bool raw;					/* print only: -raw was specified */
+} ListStmntNode;
+
+typedef struct {				/* input prompt? name, ... */
+	NODE_HEAD;
+	NodeList prompt;			/* ConstantNode per name or NULL */
+	NodeList name;				/* NameNode's */
+} InputNode;
+
+typedef struct {				/* expression NEWLINE */
+	NODE_HEAD;
+	Node *expression;
+} ExpressionNode;
+
+typedef struct {				/* all statements and functions of a module */
+	NODE_HEAD;
+	NodeList statement;
+	NodeList function;			/* FuncDefNode's in order of appearance */
+} ModuleNode;
+
+extern Node *node_alloc(nodetype_t type, size_t size);
+extern void nodelist_append(NodeList *list, Node *node);
+extern void tree_free(Node *tree);
+
+#define NODE(structname, type)	((structname *)node_alloc(type, sizeof(structname)))
+
+#endif
@@ -0,0 +1,150 @@
+/* bench.c
+ *
+ * Benchmark driver. Runs the interpreter on every benchmark program given
+ * on the command line and reports per benchmark the wall time, the number
+ * of operations per second and the peak resident set size.
+ *
+ * usage: bench [-r runs] interpreter benchmark.x ...
+ *
+ * Every benchmark is run 'runs' times (default 3); the fastest run is
+ * reported. The number of operations a benchmark performs is read from a
+ * comment line in its header:
+ *
+ *  # ops: 1000000 iterations
+ *
+ * The interpreter is started with option -n, so every run includes
+ * scanning, parsing and compiling the benchmark instead of loading its
+ * bytecode from the cache. The output of the interpreter is discarded.
+ * A benchmark which exits with a non-zero status is reported as failed,
+ * and then the driver exits with status 1.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#define _DEFAULT_SOURCE  /* fork(), wait4() and friends are not part of C99 */
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <time.h>
+
+
+/* Read the number of operations from the header of a benchmark.
+ *
+ * return	number of operations, 0 if not specified
+ */
+static double operations(const char *filename)
+{
+	char line[256];
+	double ops = 0;
+	FILE *fp;
+
+	if ((fp = fopen(filename, "r")) == NULL)
+		return 0;
+
+	while (fgets(line, sizeof(line), fp) != NULL && line[0] == '#')
+		if (sscanf(line, "# ops: %lf", &ops) == 1)
+			break;
+
+	fclose(fp);
+
+	return ops;
+}
+
+
+/* Run the interpreter once on a benchmark.
+ *
+ * seconds	wall time of the run
+ * rss		peak resident set size in kilobytes
+ * return	exit status of the interpreter, -1 if it could not be run
+ */
+static int run(char *interpreter, char *filename, double *seconds, long *rss)
+{
+	struct timespec start, end;
+	struct rusage usage;
+	int status, fd;
+	pid_t pid;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if ((pid = fork()) == -1)
+		return -1;
+
+	if (pid == 0) {  /* child */
+		if ((fd = open("/dev/null", O_WRONLY)) != -1)
+			dup2(fd, STDOUT_FILENO);
+		execl(interpreter, interpreter, "-n", filename, (char *)NULL);
+		_exit(127);
+	}
+
+	if (wait4(pid, &status, 0, &usage) == -1)
+		return -1;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	*seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	#ifdef __APPLE__
+	*rss = usage.ru_maxrss / 1024;  /* bytes on macOS */
+	#else
+	*rss = usage.ru_maxrss;  /* kilobytes on Linux */
+	#endif
+
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+
+int main(int argc, char **argv)
+{
+	double seconds, best, ops;
+	int runs = 3, failed = 0, status = 0;
+	long rss, peak;
+	char *interpreter;
+
+	if (argc > 2 && strcmp(argv[1], "-r") == 0) {
+		if ((runs = atoi(argv[2])) < 1)
+			runs = 1;
+		argc -= 2;
+		argv += 2;
+	}
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: bench [-r runs] interpreter benchmark.x ...\n");
+		return 2;
+	}
+
+	interpreter = argv[1];
+
+	printf("%-16s %10s %14s %14s\n", "benchmark", "time (s)", "ops/s", "peak RSS (KB)");
+
+	for (int i = 2; i < argc; i++) {
+		best = 0;
+		peak = 0;
+
+		for (int r = 0; r < runs; r++) {
+			if ((status = run(interpreter, argv[i], &seconds, &rss)) != 0)
+				break;
+			if (r == 0 || seconds < best)
+				best = seconds;
+			if (rss > peak)
+				peak = rss;
+		}
+
+		if (status != 0) {
+			printf("%-16s %10s (exit status %d)\n", argv[i], "failed", status);
+			failed = 1;
+			continue;
+		}
+
+		if ((ops = operations(argv[i])) > 0 && best > 0)
+			printf("%-16s %10.3f %14.0f %14ld\n", argv[i], best, ops / best, peak);
+		else
+			printf("%-16s %10.3f %14s %14ld\n", argv[i], best, "-", peak);
+	}
+
+	return failed;
+}
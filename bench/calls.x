@@ -0,0 +1,12 @@
+# calls.x
+#
+# Recursive function calls.
+#
+# ops: 1664079 calls
+
+def fib(n)
+    if n < 2
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+print fib(29)
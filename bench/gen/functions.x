@@ -0,0 +1,20 @@
+# functions.x
+#
+# Generates lib/functions.x, the module with 400 small functions which
+# benchmark import.x imports.
+#
+# usage: exin gen/functions.x > lib/functions.x
+
+print "# functions.x"
+print "#"
+print "# Module with many small functions, imported by import.x."
+print
+
+int i = 0
+while i < 400
+    print "def h" + i + "(x)"
+    print "    int y = x * " + (i % 10 + 1)
+    print "    if y > 100"
+    print "        y -= " + i
+    print "    return y + " + i
+    i += 1
@@ -0,0 +1,38 @@
+# globals.x
+#
+# Generates benchmark globals.x: 1000 global variables and 1000 functions
+# which use them, as generated scripts do.
+#
+# usage: exin gen/globals.x > globals.x
+
+int n = 1000
+
+print "# globals.x"
+print "#"
+print "# Declares many global variables and functions, as generated scripts do."
+print "# Measures the time needed to compile and resolve a large number of names."
+print "#"
+print "# ops: " + (2 * n) + " names"
+print
+
+int i = 0
+while i < n
+    print "int g" + i + " = " + i
+    i += 1
+print
+
+i = 0
+while i < n
+    print "def f" + i + "(x)"
+    print "    return x + g" + i
+    i += 1
+print
+
+print "int total = 0, n = 0"
+print "while n < 20"
+i = 0
+while i < n
+    print "    total = f" + i + "(total)"
+    i += 50
+print "    n += 1"
+print "print total"
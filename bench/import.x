@@ -0,0 +1,9 @@
+# import.x
+#
+# Importing a module with many function definitions.
+#
+# ops: 400 functions
+
+import "lib/functions.x"
+
+print h0(1) + h399(1)
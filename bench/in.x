@@ -0,0 +1,18 @@
+# in.x
+#
+# Membership tests with 'in' on a list and a string.
+#
+# ops: 200000 tests
+
+list l = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39]
+str s = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+int i = 0, found = 0
+
+while i < 100000
+    if i % 40 in l
+        found += 1
+    if 'Z' in s
+        found += 1
+    i += 1
+
+print found
@@ -0,0 +1,22 @@
+# lists.x
+#
+# Appending to a list, indexing it and iterating over it.
+#
+# ops: 900000 operations
+
+list l
+int i = 0, sum = 0
+
+while i < 300000
+    l.append(i)
+    i += 1
+
+i = 0
+while i < 300000
+    sum += l[i]
+    i += 1
+
+for x in l
+    sum -= x
+
+print l.len, sum
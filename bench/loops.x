@@ -0,0 +1,16 @@
+# loops.x
+#
+# Integer and float arithmetic in a while loop.
+#
+# ops: 1000000 iterations
+
+int i = 0, sum = 0
+float f = 0.0
+
+while i < 1000000
+    sum += i % 7
+    sum = sum + i * 2 - i / 3
+    f += 0.5
+    i += 1
+
+print sum, f
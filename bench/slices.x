@@ -0,0 +1,19 @@
+# slices.x
+#
+# Slicing lists and strings.
+#
+# ops: 400000 slices
+
+list l = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19]
+str s = "The quick brown fox jumps over the lazy dog"
+list part
+str word
+int i = 0, n = 0
+
+while i < 200000
+    part = l[i % 10:i % 10 + 10]
+    word = s[i % 20:]
+    n += part.len + word.len
+    i += 1
+
+print n
@@ -0,0 +1,21 @@
+# strings.x
+#
+# Building strings by concatenation and indexing the result.
+#
+# ops: 200000 operations
+
+str s, t
+int i = 0, n = 0
+
+while i < 100000
+    s += 'x'
+    if s[i] == 'x'
+        n += 1
+    i += 1
+
+i = 0
+while i < 1000
+    t = "abc" + s[i:i + 97]
+    i += 1
+
+print s.len, n, t.len
@@ -0,0 +1,820 @@
+/* cache.c
+ *
+ * Compiled module cache.
+ *
+ * After a module has been compiled its bytecode is saved in a cache file
+ * next to the module. The name of the cache file is the name of the module
+ * followed by a 'c', so the cache of fib.x is fib.xc. When the module is
+ * imported again the bytecode is loaded from the cache, and scanning,
+ * parsing and compiling are skipped. A cache is only used if it has the
+ * same format and was written by the same version of the interpreter, for
+ * a module with the same size, modification time and contents (hash
+ * value). Otherwise the module is compiled and the cache is written
+ * again. If a cache cannot be written the module is just compiled every
+ * time.
+ *
+ * As a cache file may be damaged, or be written by another interpreter at
+ * the same time, its contents are protected by a hash value as well, and
+ * every instruction is checked before the code is used: the opcode must
+ * exist, the operand must be a valid constant, name, local slot or jump
+ * address, and the value stack must stay within its bounds. A cache which
+ * fails a check is ignored.
+ *
+ * On systems which support it the cache file is mapped into memory and
+ * the instructions are executed directly from the mapped file.
+ *
+ * All numbers in a cache file are in the byte order of the machine which
+ * wrote it, and every item starts at a multiple of 4 bytes. After the
+ * header follow the code objects of the functions and then the code object
+ * of the module. A code object contains:
+ *
+ *  name        string
+ *  counts      size, nlocals, stacksize, nconstants, nnames
+ *  instr       size instructions
+ *  offset      size offsets
+ *  constants   per constant its type followed by its value; a position
+ *              (function) refers to an earlier code object by index
+ *  names       nnames strings
+ *
+ * A string is stored as its length followed by the characters.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#if defined(__unix__) || defined(__APPLE__)
+	#define POSIX
+	#define _DEFAULT_SOURCE  /* mmap(), mkstemp() and friends are not part of C99 */
+	#if !defined(NO_MMAP)
+		#define MMAP
+	#endif
+#endif
+
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "position.h"
+#include "number.h"
+#include "intern.h"
+#include "cache.h"
+#include "error.h"
+#include "str.h"
+
+#ifdef MMAP
+	#include <sys/mman.h>
+#endif
+
+#ifdef POSIX
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+#define MAGIC		"EXIN"
+#define BYTEORDER	0x01020304u
+
+/* Increment FORMAT after every change in the layout of a cache file, and
+ * after every change in code.h (opcodes, code objects) or in object.h
+ * (type numbers). A cache written with another format is not used.
+ */
+#define FORMAT		2
+
+
+typedef struct header {
+	char magic[4];				/* MAGIC */
+	uint32_t format;			/* FORMAT of the cache file */
+	char version[12];			/* VERSION of the interpreter */
+	uint32_t byteorder;			/* BYTEORDER as written by the machine */
+	uint32_t sizes;				/* sizeof(int_t) << 8 | sizeof(float_t) */
+	uint64_t length;			/* number of bytes in the cache file */
+	uint64_t size;				/* number of bytes in the module code */
+	int64_t mtime;				/* modification time of the module */
+	uint32_t hash;				/* hash value of the module code */
+	uint32_t check;				/* hash value of the cache after the header */
+	uint32_t ncodes;			/* number of code objects */
+} Header;
+
+
+/* Growing buffer in which a cache file is composed before writing it.
+ */
+typedef struct buffer {
+	char *data;
+	size_t size;
+	size_t capacity;
+} Buffer;
+
+
+/* Position in a cache file which is being loaded.
+ */
+typedef struct input {
+	const char *pos;
+	const char *end;
+} Input;
+
+
+/* Calculate the hash value of the module code (FNV-1a).
+ */
+static uint32_t hash(const char *s, size_t length)
+{
+	uint32_t h = 2166136261u;
+
+	while (length--)
+		h = (h ^ (unsigned char)*s++) * 16777619u;
+
+	return h;
+}
+
+
+/* Return the name of the cache file for module m (new allocation).
+ */
+static char *cachename(Module *m)
+{
+	size_t len = strlen(m->path);
+	char *name;
+
+	if ((name = malloc(len + 3)) == NULL)
+		error(OutOfMemoryError);
+
+	memcpy(name, m->path, len);
+	strcpy(name + len, "c");
+
+	return name;
+}
+
+
+/* Fill in the header for module m. The number of code objects and the
+ * length of the file are filled in by the caller.
+ *
+ * return	1 if successful else 0
+ */
+static int header(Module *m, Header *h)
+{
+	struct _stat stat_buffer;
+
+	if (_stat(m->path, &stat_buffer) != 0)
+		return 0;
+
+	memset(h, 0, sizeof(Header));
+	memcpy(h->magic, MAGIC, sizeof(h->magic));
+	h->format = FORMAT;
+	strncpy(h->version, VERSION, sizeof(h->version) - 1);
+	h->byteorder = BYTEORDER;
+	h->sizes = (uint32_t)(sizeof(int_t) << 8 | sizeof(float_t));
+	h->size = m->size;
+	h->mtime = (int64_t)stat_buffer.st_mtime;
+	h->hash = hash(m->code, m->size);
+
+	return 1;
+}
+
+
+/* Read a complete file into memory, or map it if the system supports it.
+ * The memory is never released when the cache is used, as the
+ * instructions are executed from it.
+ *
+ * return	pointer to the contents of the file or NULL if not available
+ */
+static char *map(const char *name, size_t *size)
+{
+	char *data = NULL;
+
+	#ifdef MMAP
+	struct stat stat_buffer;
+	int fd;
+
+	if ((fd = open(name, O_RDONLY)) != -1) {
+		if (fstat(fd, &stat_buffer) == 0 && stat_buffer.st_size >= (off_t)sizeof(Header)) {
+			*size = stat_buffer.st_size;
+			if ((data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+				data = NULL;
+		}
+		close(fd);
+	}
+	#else  /* not MMAP */
+	struct _stat stat_buffer;
+	FILE *fp;
+
+	if (_stat(name, &stat_buffer) == 0 && stat_buffer.st_size >= (long)sizeof(Header)) {
+		if ((fp = fopen(name, "rb")) != NULL) {
+			*size = stat_buffer.st_size;
+			if ((data = malloc(*size)) != NULL && fread(data, 1, *size, fp) != *size) {
+				free(data);
+				data = NULL;
+			}
+			fclose(fp);
+		}
+	}
+	#endif  /* MMAP */
+
+	return data;
+}
+
+
+static void unmap(char *data, size_t size)
+{
+	#ifdef MMAP
+	munmap(data, size);
+	#else  /* not MMAP */
+	free(data);
+	#endif  /* MMAP */
+}
+
+
+/* Get the next n bytes from a cache file.
+ *
+ * return	pointer to the bytes or NULL if the file is too short
+ */
+static const void *get(Input *in, size_t n)
+{
+	const char *p = in->pos;
+
+	if (n > (size_t)(in->end - in->pos))
+		return NULL;
+
+	in->pos += (n + 3) & ~(size_t)3;
+
+	if (in->pos > in->end)
+		in->pos = in->end;
+
+	return p;
+}
+
+
+static int get_u32(Input *in, uint32_t *v)
+{
+	const void *p;
+
+	if ((p = get(in, sizeof(uint32_t))) == NULL)
+		return 0;
+
+	memcpy(v, p, sizeof(uint32_t));
+
+	return 1;
+}
+
+
+/* Get a string from a cache file.
+ *
+ * return	interned string or NULL if the file is too short
+ */
+static char *get_string(Input *in)
+{
+	const char *s;
+	uint32_t len;
+
+	if (get_u32(in, &len) == 0 || (s = get(in, len)) == NULL)
+		return NULL;
+
+	return intern_n(s, len);
+}
+
+
+/* Get a constant from a cache file.
+ *
+ * codes	code objects loaded so far
+ * ncodes	number of code objects loaded so far
+ * return	new constant or NULL if the file is invalid
+ */
+static Object *get_constant(Input *in, Code **codes, uint32_t ncodes)
+{
+	PositionObject *pos;
+	const void *p;
+	uint32_t type, v;
+	int_t i;
+	float_t f;
+	char *s;
+
+	if (get_u32(in, &type) == 0)
+		return NULL;
+
+	switch (type) {
+		case CHAR_T:
+			if (get_u32(in, &v) == 0)
+				return NULL;
+			return chartype.value((char_t)v);
+		case INT_T:
+			if ((p = get(in, sizeof(int_t))) == NULL)
+				return NULL;
+			memcpy(&i, p, sizeof(int_t));
+			return inttype.value(i);
+		case FLOAT_T:
+			if ((p = get(in, sizeof(float_t))) == NULL)
+				return NULL;
+			memcpy(&f, p, sizeof(float_t));
+			return obj_create(FLOAT_T, f);
+		case STR_T:
+			if ((s = get_string(in)) == NULL)
+				return NULL;
+			return (Object *)strtype.share((StrObject *)obj_alloc(STR_T), s);
+		case POSITION_T:
+			if (get_u32(in, &v) == 0 || v >= ncodes)
+				return NULL;
+			pos = (PositionObject *)obj_alloc(POSITION_T);
+			pos->code = codes[v];
+			return (Object *)pos;
+		default:
+			return NULL;
+	}
+}
+
+
+/* Release a code object which was loaded from a damaged cache. Its
+ * instructions and offsets are part of the cache file, and its names
+ * are interned, so these are not freed.
+ */
+static void release(Code *code)
+{
+	for (int i = 0; i < code->nconstants; i++)
+		obj_decref(code->constant[i]);
+
+	free(code->constant);
+	free(code->names);
+	free(code->global);
+	free(code->lookup);
+	free(code);
+}
+
+
+/* Number of stack entries an instruction pops, *pushes receives the
+ * number of entries it pushes. For FOR_NEXT this is when it does not jump.
+ */
+static int stack_use(opcode_t opcode, unsigned int operand, int *pushes)
+{
+	*pushes = 1;
+
+	switch (opcode) {
+		case OP_LOAD_CONST: case OP_LOAD_NAME:
+			return 0;
+		case OP_BUILD_LIST:
+			return (int)operand;
+		case OP_CALL:
+			return (int)(operand >> 16);
+		case OP_SLICE:
+			return 1 + (operand & 1) + ((operand >> 1) & 1);
+		case OP_INSERT:
+			return 3;
+		case OP_LEN: case OP_NOT: case OP_NEG:
+			return 1;
+		case OP_INDEX: case OP_APPEND: case OP_REMOVE:
+		case OP_MUL: case OP_DIV: case OP_MOD: case OP_ADD: case OP_SUB:
+		case OP_LSS: case OP_LEQ: case OP_GTR: case OP_GEQ: case OP_EQL: case OP_NEQ:
+		case OP_IN: case OP_AND: case OP_OR: case OP_ASSIGN:
+			return 2;
+		case OP_FOR_PREP:
+			*pushes = 3;
+			return 1;
+		case OP_FOR_NEXT:
+			*pushes = 4;
+			return 3;
+		case OP_FOR_END:
+			*pushes = 0;
+			return 3;
+		case OP_POP: case OP_JUMP_IF_FALSE: case OP_BIND: case OP_PRINT:
+		case OP_IMPORT: case OP_RETURN:
+			*pushes = 0;
+			return 1;
+		default:
+			*pushes = 0;
+			return 0;
+	}
+}
+
+
+/* Continue at instruction target with stack depth d. An instruction is
+ * only added to the list with instructions to check when it is reached
+ * for the first time.
+ *
+ * return	1 if this is consistent with earlier visits else 0
+ */
+static int reach(Code *code, int target, int d, int *depth, int *todo, int *ntodo)
+{
+	if (target < 0 || target >= code->size)
+		return 0;
+
+	if (depth[target] == -1) {
+		depth[target] = d;
+		todo[(*ntodo)++] = target;
+		return 1;
+	}
+
+	return depth[target] == d;
+}
+
+
+/* Check if the value stack stays within its bounds: follow all paths
+ * through the code, an instruction must always be reached with the same
+ * stack depth, may not pop more entries than are on the stack and may
+ * not push more than stacksize entries. As every path has to end with a
+ * return, execution never runs past the last instruction.
+ *
+ * return	1 if the stack use is valid else 0
+ */
+static int balanced(Code *code)
+{
+	int *depth, *todo, ntodo = 0, valid;
+	int i, d, pops, pushes;
+	unsigned int operand;
+
+	if ((depth = malloc(code->size * sizeof(int))) == NULL || \
+		(todo = malloc(code->size * sizeof(int))) == NULL)
+		error(OutOfMemoryError);
+
+	for (i = 0; i < code->size; i++)
+		depth[i] = -1;
+
+	valid = reach(code, 0, 0, depth, todo, &ntodo);
+
+	while (valid && ntodo) {
+		i = todo[--ntodo];
+		operand = OPERAND(code->instr[i]);
+		pops = stack_use(OPCODE(code->instr[i]), operand, &pushes);
+
+		if (depth[i] < pops || depth[i] - pops + pushes > code->stacksize) {
+			valid = 0;
+			break;
+		}
+
+		d = depth[i] - pops + pushes;
+
+		switch (OPCODE(code->instr[i])) {
+			case OP_RETURN:
+				break;
+			case OP_JUMP:
+				valid = reach(code, (int)operand, d, depth, todo, &ntodo);
+				break;
+			case OP_JUMP_IF_FALSE:
+				valid = reach(code, (int)operand, d, depth, todo, &ntodo) && \
+						reach(code, i + 1, d, depth, todo, &ntodo);
+				break;
+			case OP_FOR_NEXT:  /* pushes no item when it jumps */
+				valid = reach(code, (int)operand, d - 1, depth, todo, &ntodo) && \
+						reach(code, i + 1, d, depth, todo, &ntodo);
+				break;
+			default:
+				valid = reach(code, i + 1, d, depth, todo, &ntodo);
+				break;
+		}
+	}
+
+	free(todo);
+	free(depth);
+
+	return valid;
+}
+
+
+/* Check if the instructions of a code object can be executed safely: the
+ * opcode must exist, an operand which refers to a constant, a name, a
+ * local slot or an instruction must be within the tables of the code,
+ * and the value stack must stay within its bounds.
+ *
+ * return	1 if the instructions are valid else 0
+ */
+static int verify(Code *code, Module *m)
+{
+	unsigned int operand;
+
+	if (code->size == 0 || code->nlocals > code->nnames)
+		return 0;
+
+	for (int i = 0; i < code->size; i++) {
+		operand = OPERAND(code->instr[i]);
+
+		if (code->offset[i] > m->size)
+			return 0;
+
+		switch (OPCODE(code->instr[i])) {
+			case OP_LOAD_CONST:
+			case OP_PROMPT:
+				if (operand >= (unsigned int)code->nconstants)
+					return 0;
+				break;
+			case OP_FUNCTION:
+				if (operand >= (unsigned int)code->nconstants || TYPE(code->constant[operand]) != POSITION_T)
+					return 0;
+				break;
+			case OP_LOAD_NAME:
+			case OP_BAD_METHOD:
+			case OP_FOR_NAME:
+			case OP_BIND:
+			case OP_INPUT:
+				if (operand >= (unsigned int)code->nnames)
+					return 0;
+				break;
+			case OP_CALL:
+				if ((operand & 0xFFFF) >= (unsigned int)code->nnames)
+					return 0;
+				break;
+			case OP_DECLARE:
+				if ((operand & 0xFFFF) >= (unsigned int)code->nnames || \
+					(operand >> 16) <= UNDEFINED || (operand >> 16) > LINES_T)
+					return 0;
+				break;
+			case OP_BIND_ARG:
+				if (operand >= (unsigned int)code->nlocals)
+					return 0;
+				break;
+			case OP_JUMP:
+			case OP_JUMP_IF_FALSE:
+			case OP_FOR_NEXT:
+				if (operand >= (unsigned int)code->size)
+					return 0;
+				break;
+			case OP_ASSIGN:
+				if (operand != 0 && (operand < OP_MUL || operand > OP_SUB))
+					return 0;
+				break;
+			default:
+				if (OPCODE(code->instr[i]) > OP_RETURN)
+					return 0;
+				break;
+		}
+	}
+
+	return balanced(code);
+}
+
+
+/* Get a code object from a cache file. The instructions and offsets are
+ * not copied, they remain in the cache file.
+ *
+ * return	code object or NULL if the file is invalid
+ */
+static Code *get_code(Input *in, Module *m, Code **codes, uint32_t ncodes)
+{
+	uint32_t n[5];
+	Object *obj;
+	Code *code;
+	char *name;
+
+	if ((name = get_string(in)) == NULL)
+		return NULL;
+
+	for (int i = 0; i < 5; i++)
+		if (get_u32(in, &n[i]) == 0 || n[i] > INT_MAX)
+			return NULL;
+
+	code = code_alloc(m, name);
+	code->size = (int)n[0];
+	code->nlocals = (int)n[1];
+	code->stacksize = (int)n[2];
+
+	if ((code->instr = (instr_t *)get(in, n[0] * sizeof(instr_t))) == NULL || \
+		(code->offset = (unsigned int *)get(in, n[0] * sizeof(unsigned int))) == NULL) {
+		release(code);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < n[3]; i++) {
+		if ((obj = get_constant(in, codes, ncodes)) == NULL) {
+			release(code);
+			return NULL;
+		}
+		code_constant(code, obj);
+	}
+
+	for (uint32_t i = 0; i < n[4]; i++)
+		if ((name = get_string(in)) == NULL || code_name(code, name) != (int)i) {
+			release(code);
+			return NULL;
+		}
+
+	if (verify(code, m) == 0) {
+		release(code);
+		return NULL;
+	}
+
+	return code;
+}
+
+
+/* Load the bytecode of module m from its cache.
+ *
+ * return	code object of the module, or NULL if there is no valid cache
+ */
+Code *cache_load(Module *m)
+{
+	Header h, *c;
+	Code **codes, *code = NULL;
+	char *name, *data;
+	size_t size;
+	uint32_t n;
+	Input in;
+
+	if (config.cache == 0 || header(m, &h) == 0)
+		return NULL;
+
+	name = cachename(m);
+	data = map(name, &size);
+	free(name);
+
+	if (data == NULL)
+		return NULL;
+
+	c = (Header *)data;
+
+	if (memcmp(c->magic, h.magic, sizeof(h.magic)) != 0 || c->format != h.format || \
+		memcmp(c->version, h.version, sizeof(h.version)) != 0 || \
+		c->byteorder != h.byteorder || c->sizes != h.sizes || \
+		c->length != size || c->size != h.size || c->mtime != h.mtime || \
+		c->hash != h.hash || c->ncodes == 0 || c->ncodes > INT_MAX || \
+		c->check != hash(data + sizeof(Header), size - sizeof(Header))) {
+		unmap(data, size);
+		return NULL;
+	}
+
+	if ((codes = calloc(c->ncodes, sizeof(Code *))) == NULL)
+		error(OutOfMemoryError);
+
+	in.pos = data + sizeof(Header);
+	in.end = data + size;
+
+	for (n = 0; n < c->ncodes; n++)
+		if ((code = codes[n] = get_code(&in, m, codes, n)) == NULL)
+			break;
+
+	if (code == NULL) {  /* cache is damaged, release the code loaded so far */
+		while (n--)
+			release(codes[n]);
+		unmap(data, size);
+	}
+
+	free(codes);
+
+	return code;
+}
+
+
+static void put(Buffer *b, const void *data, size_t n)
+{
+	size_t padded = (n + 3) & ~(size_t)3;
+	char *p;
+
+	if (b->size + padded > b->capacity) {
+		b->capacity = b->capacity ? b->capacity * 2 : 4096;
+		while (b->size + padded > b->capacity)
+			b->capacity *= 2;
+		if ((p = realloc(b->data, b->capacity)) == NULL)
+			error(OutOfMemoryError);
+		b->data = p;
+	}
+
+	memcpy(b->data + b->size, data, n);
+	memset(b->data + b->size + n, 0, padded - n);
+
+	b->size += padded;
+}
+
+
+static void put_u32(Buffer *b, uint32_t v)
+{
+	put(b, &v, sizeof(uint32_t));
+}
+
+
+static void put_string(Buffer *b, const char *s, size_t len)
+{
+	put_u32(b, (uint32_t)len);
+	put(b, s, len);
+}
+
+
+/* Add a code object to the cache file. The code objects of the functions
+ * it refers to are added first.
+ *
+ * return	index of the code object in the cache file
+ */
+static uint32_t put_code(Buffer *b, Code *code, uint32_t *ncodes)
+{
+	uint32_t *index;
+	Object *obj;
+
+	if ((index = calloc(code->nconstants + 1, sizeof(uint32_t))) == NULL)
+		error(OutOfMemoryError);
+
+	for (int i = 0; i < code->nconstants; i++)
+		if (TYPE(code->constant[i]) == POSITION_T)
+			index[i] = put_code(b, ((PositionObject *)code->constant[i])->code, ncodes);
+
+	put_string(b, code->name, strlen(code->name));
+	put_u32(b, (uint32_t)code->size);
+	put_u32(b, (uint32_t)code->nlocals);
+	put_u32(b, (uint32_t)code->stacksize);
+	put_u32(b, (uint32_t)code->nconstants);
+	put_u32(b, (uint32_t)code->nnames);
+	put(b, code->instr, code->size * sizeof(instr_t));
+	put(b, code->offset, code->size * sizeof(unsigned int));
+
+	for (int i = 0; i < code->nconstants; i++) {
+		obj = code->constant[i];
+		put_u32(b, (uint32_t)TYPE(obj));
+		switch (TYPE(obj)) {
+			case CHAR_T:
+				put_u32(b, (uint32_t)(unsigned char)((CharObject *)obj)->cval);
+				break;
+			case INT_T:
+				put(b, &((IntObject *)obj)->ival, sizeof(int_t));
+				break;
+			case FLOAT_T:
+				put(b, &((FloatObject *)obj)->fval, sizeof(float_t));
+				break;
+			case STR_T:
+				put_string(b, ((StrObject *)obj)->sptr, ((StrObject *)obj)->len);
+				break;
+			case POSITION_T:
+				put_u32(b, index[i]);
+				break;
+			default:
+				error(SystemError, "cannot cache constant of type %s", TYPENAME(obj));
+		}
+	}
+
+	for (int i = 0; i < code->nnames; i++)
+		put_string(b, code->names[i], intern_length(code->names[i]));
+
+	free(index);
+
+	return (*ncodes)++;
+}
+
+
+/* Create a temporary file next to cache file name. Where possible the
+ * temporary file gets a unique name, so interpreters which compile the
+ * same module at the same time never write to the same file.
+ *
+ * temp		receives the name of the temporary file (new allocation)
+ * return	the opened file or NULL if it cannot be created
+ */
+static FILE *create(const char *name, char **temp)
+{
+	FILE *fp = NULL;
+	#ifdef POSIX
+	int fd;
+	#endif  /* POSIX */
+
+	if ((*temp = malloc(strlen(name) + 8)) == NULL)
+		error(OutOfMemoryError);
+
+	strcpy(*temp, name);
+
+	#ifdef POSIX
+	strcat(*temp, ".XXXXXX");
+
+	if ((fd = mkstemp(*temp)) != -1) {
+		fchmod(fd, 0644);  /* mkstemp() makes the file private */
+		if ((fp = fdopen(fd, "wb")) == NULL) {
+			close(fd);
+			remove(*temp);
+		}
+	}
+	#else  /* not POSIX */
+	strcat(*temp, "~");  /* the hash value of the contents detects a mix-up */
+
+	fp = fopen(*temp, "wb");
+	#endif  /* POSIX */
+
+	return fp;
+}
+
+
+/* Save the bytecode of module m in its cache. The file is written under
+ * a temporary name first and then renamed, so a half written cache is
+ * never used.
+ */
+void cache_save(Module *m)
+{
+	Buffer b = { NULL, 0, 0 };
+	char *name, *temp;
+	uint32_t ncodes = 0;
+	bool written;
+	Header h;
+	FILE *fp;
+
+	if (config.cache == 0 || header(m, &h) == 0)
+		return;
+
+	put(&b, &h, sizeof(Header));
+	put_code(&b, m->bytecode, &ncodes);
+
+	h.ncodes = ncodes;
+	h.length = b.size;
+	h.check = hash(b.data + sizeof(Header), b.size - sizeof(Header));
+	memcpy(b.data, &h, sizeof(Header));
+
+	name = cachename(m);
+
+	if ((fp = create(name, &temp)) != NULL) {
+		written = fwrite(b.data, 1, b.size, fp) == b.size && fflush(fp) == 0;
+		#ifdef POSIX
+		written = written && fsync(fileno(fp)) == 0;  /* on disk before it gets its name */
+		#endif  /* POSIX */
+		if (fclose(fp) != 0 || written == false || rename(temp, name) != 0)
+			remove(temp);
+	}
+
+	free(temp);
+	free(name);
+	free(b.data);
+}
@@ -0,0 +1,14 @@
+/* cache.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _CACHE_
+#define _CACHE_
+
+#include "module.h"
+#include "code.h"
+
+extern Code *cache_load(Module *m);
+extern void cache_save(Module *m);
+
+#endif
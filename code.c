@@ -0,0 +1,214 @@
+/* code.c
+ *
+ * Code objects contain the bytecode of a module or a function, together
+ * with the tables of constants and names the instructions refer to.
+ *
+ * Code objects are never released because the code of a module remains
+ * loaded during the lifetime of the interpreter.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <assert.h>
+#include <stdlib.h>
+
+#include "identifier.h"
+#include "code.h"
+#include "error.h"
+
+
+/* Create a new empty code object.
+ *
+ * module   module containing the source of the code
+ * name     module or function name
+ * return   pointer to new code object
+ */
+Code *code_alloc(Module *module, char *name)
+{
+	Code *code;
+
+	if ((code = calloc(1, sizeof(Code))) == NULL)
+		error(OutOfMemoryError);
+
+	code->module = module;
+	code->name = name;
+
+	return code;
+}
+
+
+/* Add an instruction to the end of the code.
+ *
+ * code     code object to add the instruction to
+ * opcode   instruction opcode
+ * operand  instruction operand, 0 if not used
+ * offset   offset in the module code of the source of the instruction
+ * return   address of the instruction
+ */
+int code_emit(Code *code, opcode_t opcode, unsigned int operand, unsigned int offset)
+{
+	instr_t *instr;
+	unsigned int *off;
+
+	assert(code != NULL);
+
+	if (operand > MAXOPERAND)
+		error(SystemError, "instruction operand %u out of range", operand);
+
+	if (code->size == code->capacity) {
+		code->capacity = code->capacity ? code->capacity * 2 : 64;
+		if ((instr = realloc(code->instr, code->capacity * sizeof(instr_t))) == NULL)
+			error(OutOfMemoryError);
+		if ((off = realloc(code->offset, code->capacity * sizeof(unsigned int))) == NULL)
+			error(OutOfMemoryError);
+		code->instr = instr;
+		code->offset = off;
+	}
+
+	code->instr[code->size] = INSTR(opcode, operand);
+	code->offset[code->size] = offset;
+
+	return code->size++;
+}
+
+
+/* Add an object to the table with constants.
+ *
+ * code     code object to add the constant to
+ * obj      constant, must remain available during the lifetime of code
+ * return   index of the constant in the table
+ */
+int code_constant(Code *code, Object *obj)
+{
+	Object **constant;
+
+	assert(code != NULL);
+
+	if ((constant = realloc(code->constant, (code->nconstants + 1) * sizeof(Object *))) == NULL)
+		error(OutOfMemoryError);
+
+	code->constant = constant;
+	code->constant[code->nconstants] = obj;
+
+	return code->nconstants++;
+}
+
+
+/* Find the entry in the name lookup table of a code object for the name
+ * with a certain global slot. As the global slot is unique for every name
+ * it is used as hash value.
+ *
+ * return   index of the entry which contains the index of the name, or
+ *          if the name is not in the table, of the empty entry to use
+ */
+static unsigned int probe(Code *code, int slot)
+{
+	unsigned int i, mask = code->lookupsize - 1;
+
+	for (i = ((unsigned int)slot * 2654435761u) & mask; code->lookup[i] != -1; i = (i + 1) & mask)
+		if (code->global[code->lookup[i]] == slot)
+			break;
+
+	return i;
+}
+
+
+/* Double the size of the name lookup table and reinsert all names.
+ */
+static void grow(Code *code)
+{
+	free(code->lookup);
+
+	code->lookupsize = code->lookupsize ? code->lookupsize * 2 : 32;
+
+	if ((code->lookup = malloc(code->lookupsize * sizeof(int))) == NULL)
+		error(OutOfMemoryError);
+
+	for (unsigned int i = 0; i < code->lookupsize; i++)
+		code->lookup[i] = -1;
+
+	for (int n = 0; n < code->nnames; n++)
+		code->lookup[probe(code, code->global[n])] = n;
+}
+
+
+/* Add a name to the table with names. Every name occurs only once and
+ * receives a global slot.
+ *
+ * code     code object to add the name to
+ * name     name to add, must remain available during the lifetime of code
+ * return   index of the name in the table
+ */
+int code_name(Code *code, char *name)
+{
+	char **names;
+	int *global;
+	int slot;
+	unsigned int i;
+
+	assert(code != NULL);
+	assert(name != NULL);
+
+	if (2 * (unsigned int)(code->nnames + 1) > code->lookupsize)  /* keep load factor <= 0.5 */
+		grow(code);
+
+	slot = scope.slot(name);
+
+	if (code->lookup[i = probe(code, slot)] != -1)
+		return code->lookup[i];
+
+	if ((names = realloc(code->names, (code->nnames + 1) * sizeof(char *))) == NULL)
+		error(OutOfMemoryError);
+
+	if ((global = realloc(code->global, (code->nnames + 1) * sizeof(int))) == NULL)
+		error(OutOfMemoryError);
+
+	code->names = names;
+	code->names[code->nnames] = name;
+	code->global = global;
+	code->global[code->nnames] = slot;
+	code->lookup[i] = code->nnames;
+
+	return code->nnames++;
+}
+
+
+#ifdef DEBUG
+/* Print the instructions of a code object.
+ */
+void code_dump(Code *code)
+{
+	static char *opcodename[] = {
+		"LOAD_CONST", "LOAD_NAME", "BUILD_LIST", "CALL", "INDEX", "SLICE",
+		"INSERT", "APPEND", "REMOVE", "LEN", "BAD_METHOD", "NOT", "NEG",
+		"MUL", "DIV", "MOD", "ADD", "SUB", "LSS", "LEQ", "GTR", "GEQ", "EQL",
+		"NEQ", "IN", "AND", "OR", "ASSIGN", "POP", "JUMP", "JUMP_IF_FALSE",
+		"FOR_NAME", "FOR_PREP", "FOR_NEXT", "FOR_END", "BIND", "DECLARE",
+		"FUNCTION", "BIND_ARG", "PRINT", "PRINT_NEWLINE", "PROMPT", "INPUT",
+		"IMPORT", "RETURN" };
+	instr_t instr;
+
+	printf("\ncode  : %s (stacksize %d, locals %d)", code->name, code->stacksize, code->nlocals);
+
+	for (int i = 0; i < code->size; i++) {
+		instr = code->instr[i];
+		printf("\n%6d: %-14s %u", i, opcodename[OPCODE(instr)], OPERAND(instr));
+		switch (OPCODE(instr)) {
+			case OP_LOAD_NAME:
+			case OP_BAD_METHOD:
+			case OP_FOR_NAME:
+			case OP_BIND:
+			case OP_BIND_ARG:
+			case OP_INPUT:
+				printf(" (%s)", code->names[OPERAND(instr)]);
+				break;
+			case OP_CALL:
+			case OP_DECLARE:
+				printf(" (%s)", code->names[OPERAND(instr) & 0xFFFF]);
+				break;
+			default:
+				break;
+		}
+	}
+	fflush(stdout);
+}
+#endif  /* DEBUG */
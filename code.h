@@ -0,0 +1,108 @@
+/* code.h
+ *
+ * Bytecode.
+ *
+ * Every instruction is a 32 bit word. The lowest 8 bits contain the
+ * opcode, the highest 24 bits an (optional) operand. Depending on the
+ * opcode the operand is an index in the table with constants, an index
+ * in the table with names, a jump address or a small number.
+ *
+ * The index of a name is also its local slot in a function. Every name
+ * has a global slot too (see identifier.c). Variables are searched in
+ * their local slot first and, if not declared there, in their global slot.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _CODE_
+#define _CODE_
+
+#include <stdint.h>
+#include "object.h"
+#include "module.h"
+
+typedef enum {
+	/* opcode				   operand				stack effect */
+	OP_LOAD_CONST,			/* constant				push copy of constant */
+	OP_LOAD_NAME,			/* name					push variable */
+	OP_BUILD_LIST,			/* count				pop items, push list */
+	OP_CALL,				/* name | argc << 16	pop arguments, push result */
+	OP_INDEX,				/* 1 = lvalue			pop index and sequence, push item */
+	OP_SLICE,				/* 1 = start, 2 = end	pop start?, end? and sequence, push slice */
+	OP_INSERT,				/*						pop value, index and list, push none */
+	OP_APPEND,				/*						pop value and list, push none */
+	OP_REMOVE,				/*						pop index and list, push item */
+	OP_LEN,					/*						pop sequence, push length */
+	OP_BAD_METHOD,			/* name					raise error for unknown method */
+	OP_NOT,					/*						pop operand, push result */
+	OP_NEG,					/*						pop operand, push result */
+	OP_MUL,					/*						pop 2 operands, push result */
+	OP_DIV,
+	OP_MOD,
+	OP_ADD,
+	OP_SUB,
+	OP_LSS,
+	OP_LEQ,
+	OP_GTR,
+	OP_GEQ,
+	OP_EQL,
+	OP_NEQ,
+	OP_IN,
+	OP_AND,
+	OP_OR,
+	OP_ASSIGN,				/* 0 or binary opcode	pop value, assign to top */
+	OP_POP,					/*						pop and release top */
+	OP_JUMP,				/* address */
+	OP_JUMP_IF_FALSE,		/* address				pop condition */
+	OP_FOR_NAME,			/* name					search or create loop variable */
+	OP_FOR_PREP,			/*						pop sequence, push sequence, length, counter */
+	OP_FOR_NEXT,			/* address				push next item or jump when done */
+	OP_FOR_END,				/*						pop sequence, length, counter */
+	OP_BIND,				/* name					pop and bind to variable */
+	OP_DECLARE,				/* name | type << 16	create variable */
+	OP_FUNCTION,			/* constant				bind function to new global identifier */
+	OP_BIND_ARG,			/* name					bind next argument to local variable */
+	OP_PRINT,				/* 1 = separator		pop and print */
+	OP_PRINT_NEWLINE,
+	OP_PROMPT,				/* constant				print constant */
+	OP_INPUT,				/* name					read variable from stdin */
+	OP_IMPORT,				/*						pop name and import module */
+	OP_RETURN				/*						pop return value and exit */
+} opcode_t;
+
+typedef uint32_t instr_t;
+
+#define OPCODE(i)			((opcode_t)((i) & 0xFF))
+#define OPERAND(i)			((unsigned int)((i) >> 8))
+#define INSTR(op, operand)	((instr_t)(op) | ((instr_t)(operand) << 8))
+#define MAXOPERAND			0xFFFFFF
+
+/* A code object contains the instructions of a module or a function.
+ * For every instruction the offset of its source in the module code is
+ * stored, so the line where an error occurred can be reported.
+ */
+typedef struct code {
+	char *name;					/* module or function name */
+	struct module *module;		/* module containing the source */
+	instr_t *instr;				/* instructions */
+	unsigned int *offset;		/* offset in module code per instruction */
+	int size;					/* number of instructions */
+	int capacity;				/* number of instructions allocated */
+	Object **constant;			/* constants table */
+	int nconstants;
+	char **names;				/* names table */
+	int *global;				/* global slot per name */
+	int nnames;
+	int *lookup;				/* hash table with name indices, -1 = empty */
+	unsigned int lookupsize;	/* number of entries, always a power of 2 */
+	int nlocals;				/* number of local slots, 0 for a module */
+	int stacksize;				/* maximum number of stack entries used */
+	struct profile *profile;	/* profiling data, NULL if not profiled */
+} Code;
+
+extern Code *code_alloc(struct module *module, char *name);
+extern int code_emit(Code *code, opcode_t opcode, unsigned int operand, unsigned int offset);
+extern int code_constant(Code *code, Object *obj);
+extern int code_name(Code *code, char *name);
+extern void code_dump(Code *code);
+
+#endif
@@ -0,0 +1,643 @@
+/* compile.c
+ *
+ * Bytecode compiler.
+ *
+ * Converts the syntax tree of a module into bytecode (see code.h). Every
+ * function gets its own code object. The code object of the module starts
+ * with the creation of the function identifiers, followed by the code for
+ * the statements of the module.
+ *
+ * Loops are translated into jumps. Break and continue jump to the end or
+ * the start of the enclosing loop. Outside a loop they end the function,
+ * or at module level, the current statement. All jump addresses are known
+ * when a code object is complete; jumps which land on another jump are
+ * then redirected to its final destination.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <assert.h>
+#include <stdlib.h>
+
+#include "position.h"
+#include "number.h"
+#include "compile.h"
+#include "scanner.h"
+#include "ast.h"
+#include "reader.h"
+#include "error.h"
+
+
+static void statement(Node *node);
+static void expression(Node *node);
+static void lvalue(Node *node);
+
+
+/* Break and continue statements whose jump address is not known yet.
+ */
+typedef struct jumps {
+	int count;
+	int *address;				/* address of the JUMP instructions */
+} Jumps;
+
+/* Administration of the loop which is being compiled. For break and
+ * continue outside a loop a pseudo loop is used.
+ */
+typedef struct loop {
+	Jumps breaks;
+	Jumps continues;
+	struct loop *outer;			/* enclosing loop */
+} Loop;
+
+
+static Code *code;				/* code object which is being generated */
+static int depth;				/* number of entries currently on the stack */
+static Loop *loop;				/* innermost loop */
+static int zero;				/* index of constant integer 0 */
+
+
+/* Number of stack entries an instruction pushes (> 0) or pops (< 0).
+ */
+static int stack_effect(opcode_t opcode, unsigned int operand)
+{
+	switch (opcode) {
+		case OP_LOAD_CONST:
+		case OP_LOAD_NAME:
+		case OP_FOR_NEXT:
+			return 1;
+		case OP_BUILD_LIST:
+			return 1 - (int)operand;
+		case OP_CALL:
+			return 1 - (int)(operand >> 16);
+		case OP_SLICE:
+			return -((operand & 1) + ((operand >> 1) & 1));
+		case OP_INSERT:
+			return -2;
+		case OP_FOR_PREP:
+			return 2;
+		case OP_FOR_END:
+			return -3;
+		case OP_INDEX: case OP_APPEND: case OP_REMOVE:
+		case OP_MUL: case OP_DIV: case OP_MOD: case OP_ADD: case OP_SUB:
+		case OP_LSS: case OP_LEQ: case OP_GTR: case OP_GEQ: case OP_EQL: case OP_NEQ:
+		case OP_IN: case OP_AND: case OP_OR:
+		case OP_ASSIGN: case OP_POP: case OP_JUMP_IF_FALSE: case OP_BIND:
+		case OP_PRINT: case OP_IMPORT: case OP_RETURN:
+			return -1;
+		default:
+			return 0;
+	}
+}
+
+
+/* Add an instruction to the code object and keep track of the stack depth.
+ *
+ * return   address of the instruction
+ */
+static int emit(opcode_t opcode, unsigned int operand, Node *node)
+{
+	depth += stack_effect(opcode, operand);
+
+	if (depth > code->stacksize)
+		code->stacksize = depth;
+
+	return code_emit(code, opcode, operand, node->offset);
+}
+
+
+/* Set the address of a previously emitted jump instruction.
+ */
+static void patch(int address, int target)
+{
+	code->instr[address] = INSTR(OPCODE(code->instr[address]), target);
+}
+
+
+static void jumps_add(Jumps *jumps, int address)
+{
+	int *a;
+
+	if ((a = realloc(jumps->address, (jumps->count + 1) * sizeof(int))) == NULL)
+		error(OutOfMemoryError);
+
+	jumps->address = a;
+	jumps->address[jumps->count++] = address;
+}
+
+
+static void jumps_patch(Jumps *jumps, int target)
+{
+	for (int i = 0; i < jumps->count; i++)
+		patch(jumps->address[i], target);
+
+	free(jumps->address);
+	jumps->address = NULL;
+	jumps->count = 0;
+}
+
+
+/* Redirect jumps which land on an unconditional jump to the final target
+ * of the chain. This happens for example at the end of an if statement at
+ * the end of a loop body, or for a break in an if statement.
+ */
+static void thread_jumps(Code *code)
+{
+	int target, hops;
+
+	for (int i = 0; i < code->size; i++) {
+		switch (OPCODE(code->instr[i])) {
+			case OP_JUMP:
+			case OP_JUMP_IF_FALSE:
+			case OP_FOR_NEXT:
+				target = OPERAND(code->instr[i]);
+				for (hops = 0; target < code->size && OPCODE(code->instr[target]) == OP_JUMP && hops < code->size; hops++)
+					target = OPERAND(code->instr[target]);  /* hops prevents endless loops */
+				code->instr[i] = INSTR(OPCODE(code->instr[i]), target);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+
+/* Start compiling a (pseudo) loop.
+ */
+static void loop_enter(Loop *l)
+{
+	l->breaks.count = l->continues.count = 0;
+	l->breaks.address = l->continues.address = NULL;
+	l->outer = loop;
+	loop = l;
+}
+
+
+/* Finish compiling a (pseudo) loop. All break and continue statements
+ * jump to their final addresses.
+ */
+static void loop_leave(int break_target, int continue_target)
+{
+	jumps_patch(&loop->breaks, break_target);
+	jumps_patch(&loop->continues, continue_target);
+	loop = loop->outer;
+}
+
+
+/* Translate an operator token into the opcode which executes it.
+ */
+static opcode_t operator(token_t t)
+{
+	switch (t) {
+		case STAR: case STAREQUAL:
+			return OP_MUL;
+		case SLASH: case SLASHEQUAL:
+			return OP_DIV;
+		case PERCENT: case PERCENTEQUAL:
+			return OP_MOD;
+		case PLUS: case PLUSEQUAL:
+			return OP_ADD;
+		case MINUS: case MINUSEQUAL:
+			return OP_SUB;
+		case LESS:
+			return OP_LSS;
+		case LESSEQUAL:
+			return OP_LEQ;
+		case GREATER:
+			return OP_GTR;
+		case GREATEREQUAL:
+			return OP_GEQ;
+		case EQEQUAL:
+			return OP_EQL;
+		case NOTEQUAL:
+			return OP_NEQ;
+		case IN:
+			return OP_IN;
+		case AND:
+			return OP_AND;
+		case OR:
+			return OP_OR;
+		default:
+			error(SystemError, "unknown operator %s", tokenName(t));
+	}
+	return 0;
+}
+
+
+/* Generate the code for a function call.
+ */
+static void call(CallNode *node)
+{
+	int name = code_name(code, node->name);
+
+	if (node->argument.count > 0xFF)
+		error(SyntaxError, "too many arguments in call to %s", node->name);
+	if (name > 0xFFFF)
+		error(SyntaxError, "too many names in %s", code->name);
+
+	for (int i = 0; i < node->argument.count; i++)
+		expression(node->argument.item[i]);
+
+	emit(OP_CALL, name | node->argument.count << 16, (Node *)node);
+}
+
+
+/* Generate the code for a method call.
+ */
+static void method(MethodNode *node)
+{
+	if (node->method == LEN_M)
+		expression(node->object);
+	else
+		lvalue(node->object);
+
+	for (int i = 0; i < node->argument.count; i++)
+		expression(node->argument.item[i]);
+
+	switch (node->method) {
+		case INSERT_M:
+			emit(OP_INSERT, 0, (Node *)node);
+			break;
+		case APPEND_M:
+			emit(OP_APPEND, 0, (Node *)node);
+			break;
+		case REMOVE_M:
+			emit(OP_REMOVE, 0, (Node *)node);
+			break;
+		case LEN_M:
+			emit(OP_LEN, 0, (Node *)node);
+			break;
+		default:
+			emit(OP_BAD_METHOD, code_name(code, node->name), (Node *)node);
+	}
+}
+
+
+/* Generate the code for an expression. The code leaves one object, the
+ * result of the expression, on the stack.
+ */
+static void expression(Node *node)
+{
+	switch (node->type) {
+		case CONSTANT_N:
+			emit(OP_LOAD_CONST, code_constant(code, ((ConstantNode *)node)->value), node);
+			break;
+		case LISTEXPR_N:
+		{
+			NodeList *element = &((ListExprNode *)node)->element;
+
+			for (int i = 0; i < element->count; i++)
+				expression(element->item[i]);
+			emit(OP_BUILD_LIST, element->count, node);
+			break;
+		}
+		case NAME_N:
+			emit(OP_LOAD_NAME, code_name(code, ((NameNode *)node)->name), node);
+			break;
+		case CALL_N:
+			call((CallNode *)node);
+			break;
+		case INDEX_N:
+			expression(((IndexNode *)node)->sequence);
+			expression(((IndexNode *)node)->index);
+			emit(OP_INDEX, 0, node);  /* only the value */
+			break;
+		case SLICE_N:
+		{
+			SliceNode *slice = (SliceNode *)node;
+
+			expression(slice->sequence);
+			if (slice->start)
+				expression(slice->start);
+			if (slice->end)
+				expression(slice->end);
+			emit(OP_SLICE, (slice->start ? 1 : 0) | (slice->end ? 2 : 0), node);
+			break;
+		}
+		case METHOD_N:
+			method((MethodNode *)node);
+			break;
+		case UNARY_N:
+			expression(((UnaryNode *)node)->operand);
+			emit(((UnaryNode *)node)->operator == NOT ? OP_NOT : OP_NEG, 0, node);
+			break;
+		case BINARY_N:
+			expression(((BinaryNode *)node)->left);
+			expression(((BinaryNode *)node)->right);
+			emit(operator(((BinaryNode *)node)->operator), 0, node);
+			break;
+		case ASSIGN_N:
+		{
+			AssignNode *assign = (AssignNode *)node;
+
+			lvalue(assign->target);
+			expression(assign->value);
+			emit(OP_ASSIGN, assign->operator == EQUAL ? 0 : operator(assign->operator), node);
+			break;
+		}
+		case COMMA_N:
+			expression(((CommaNode *)node)->left);
+			emit(OP_POP, 0, node);
+			expression(((CommaNode *)node)->right);
+			break;
+		default:
+			error(SystemError, "unknown expression node %d", node->type);
+	}
+}
+
+
+/* Generate the code for an expression whose result can be changed: the
+ * target of an assignment, the list of a method which changes the list,
+ * the sequence of a for loop (whose variable refers to the items) and a
+ * return value. Indexing a list then yields the listnode, which is an
+ * lvalue, instead of just the value stored in it (see list.c).
+ */
+static void lvalue(Node *node)
+{
+	switch (node->type) {
+		case INDEX_N:
+			lvalue(((IndexNode *)node)->sequence);
+			expression(((IndexNode *)node)->index);
+			emit(OP_INDEX, 1, node);
+			break;
+		case COMMA_N:
+			expression(((CommaNode *)node)->left);
+			emit(OP_POP, 0, node);
+			lvalue(((CommaNode *)node)->right);
+			break;
+		default:
+			expression(node);
+	}
+}
+
+
+/* Generate the code for the statements in a block.
+ */
+static void block(Node *node)
+{
+	NodeList *list = &((BlockNode *)node)->statement;
+
+	for (int i = 0; i < list->count; i++)
+		statement(list->item[i]);
+}
+
+
+static void variable_declaration(VarDeclNode *node)
+{
+	int name;
+
+	for (int i = 0; i < node->name.count; i++) {
+		name = code_name(code, ((NameNode *)node->name.item[i])->name);
+		emit(OP_DECLARE, name | node->vartype << 16, (Node *)node);
+		if (node->value.item[i]) {
+			emit(OP_LOAD_NAME, name, (Node *)node);
+			expression(node->value.item[i]);
+			emit(OP_ASSIGN, 0, (Node *)node);
+			emit(OP_POP, 0, (Node *)node);
+		}
+	}
+}
+
+
+static void if_stmnt(IfNode *node)
+{
+	int jump_false, jump_end;
+
+	expression(node->condition);
+	jump_false = emit(OP_JUMP_IF_FALSE, 0, (Node *)node);
+	block(node->consequent);
+
+	if (node->alternative) {
+		jump_end = emit(OP_JUMP, 0, (Node *)node);
+		patch(jump_false, code->size);
+		block(node->alternative);
+		patch(jump_end, code->size);
+	} else
+		patch(jump_false, code->size);
+}
+
+
+static void while_stmnt(LoopNode *node)
+{
+	int start = code->size, jump_false;
+	Loop l;
+
+	loop_enter(&l);
+
+	expression(node->condition);
+	jump_false = emit(OP_JUMP_IF_FALSE, 0, node->condition);
+	block(node->body);
+	emit(OP_JUMP, start, (Node *)node);
+	patch(jump_false, code->size);
+
+	loop_leave(code->size, start);
+}
+
+
+static void do_stmnt(LoopNode *node)
+{
+	int start = code->size, test, jump_false;
+	Loop l;
+
+	loop_enter(&l);
+
+	block(node->body);
+	test = code->size;
+	expression(node->condition);
+	jump_false = emit(OP_JUMP_IF_FALSE, 0, node->condition);
+	emit(OP_JUMP, start, node->condition);
+	patch(jump_false, code->size);
+
+	loop_leave(code->size, test);
+}
+
+
+/* Stack during the loop: sequence, length, counter
+ */
+static void for_stmnt(ForNode *node)
+{
+	int name = code_name(code, node->name), next, end;
+	Loop l;
+
+	emit(OP_FOR_NAME, name, (Node *)node);
+	lvalue(node->sequence);
+	emit(OP_FOR_PREP, 0, (Node *)node);
+
+	loop_enter(&l);
+
+	next = emit(OP_FOR_NEXT, 0, (Node *)node);
+	emit(OP_BIND, name, (Node *)node);
+	block(node->body);
+	emit(OP_JUMP, next, (Node *)node);
+	end = emit(OP_FOR_END, 0, (Node *)node);
+	patch(next, end);
+
+	loop_leave(end, next);
+}
+
+
+/* Generate the code for a statement. Statements leave the stack as they
+ * found it.
+ */
+static void statement(Node *node)
+{
+	NodeList *list;
+
+	reader.pos = reader.current->code + node->offset;  /* for error messages */
+
+	switch (node->type) {
+		case EXPRESSION_N:
+			expression(((ExpressionNode *)node)->expression);
+			emit(OP_POP, 0, node);
+			break;
+		case VARDECL_N:
+			variable_declaration((VarDeclNode *)node);
+			break;
+		case FUNCDEF_N:  /* functions are compiled separately */
+		case PASS_N:
+			break;
+		case IF_N:
+			if_stmnt((IfNode *)node);
+			break;
+		case WHILE_N:
+			while_stmnt((LoopNode *)node);
+			break;
+		case DO_N:
+			do_stmnt((LoopNode *)node);
+			break;
+		case FOR_N:
+			for_stmnt((ForNode *)node);
+			break;
+		case IMPORT_N:
+			list = &((ListStmntNode *)node)->expression;
+			for (int i = 0; i < list->count; i++) {
+				expression(list->item[i]);
+				emit(OP_IMPORT, 0, node);
+			}
+			break;
+		case PRINT_N:
+			list = &((ListStmntNode *)node)->expression;
+			for (int i = 0; i < list->count; i++) {
+				expression(list->item[i]);
+				emit(OP_PRINT, i > 0 && ((ListStmntNode *)node)->raw == false, node);
+			}
+			if (((ListStmntNode *)node)->raw == false)
+				emit(OP_PRINT_NEWLINE, 0, node);
+			break;
+		case INPUT_N:
+		{
+			InputNode *input = (InputNode *)node;
+
+			for (int i = 0; i < input->name.count; i++) {
+				if (input->prompt.item[i])
+					emit(OP_PROMPT, code_constant(code, ((ConstantNode *)input->prompt.item[i])->value), node);
+				emit(OP_INPUT, code_name(code, ((NameNode *)input->name.item[i])->name), node);
+			}
+			break;
+		}
+		case RETURN_N:
+			list = &((ListStmntNode *)node)->expression;
+			if (list->count == 0)
+				emit(OP_LOAD_CONST, zero, node);
+			else
+				lvalue(list->item[0]);
+			emit(OP_RETURN, 0, node);
+			break;
+		case BREAK_N:
+			jumps_add(&loop->breaks, emit(OP_JUMP, 0, node));
+			break;
+		case CONTINUE_N:
+			jumps_add(&loop->continues, emit(OP_JUMP, 0, node));
+			break;
+		default:
+			error(SystemError, "unknown statement node %d", node->type);
+	}
+}
+
+
+/* Start a new code object.
+ */
+static void begin(char *name)
+{
+	code = code_alloc(reader.current, name);
+	depth = 0;
+	zero = code_constant(code, inttype.value(0));
+}
+
+
+/* Generate the code for a function. Break and continue outside a loop
+ * end the function.
+ *
+ * return   position object to bind to the function identifier
+ */
+static PositionObject *function(FuncDefNode *node)
+{
+	PositionObject *pos;
+	Loop l;
+
+	begin(node->name);
+
+	for (int i = 0; i < node->parameter.count; i++)
+		emit(OP_BIND_ARG, code_name(code, ((NameNode *)node->parameter.item[i])->name), (Node *)node);
+
+	loop_enter(&l);
+	block(node->body);
+	loop_leave(code->size, code->size);
+
+	emit(OP_LOAD_CONST, zero, (Node *)node);  /* without return value return integer 0 */
+	emit(OP_RETURN, 0, (Node *)node);
+
+	thread_jumps(code);
+
+	code->nlocals = code->nnames;  /* every name has a local slot */
+
+	pos = (PositionObject *)obj_alloc(POSITION_T);
+	pos->code = code;
+
+	return pos;
+}
+
+
+/* Compile the syntax tree of module m, which must be the module the
+ * reader is currently in.
+ *
+ * return   code object for the module
+ */
+Code *compile(Module *m)
+{
+	ModuleNode *tree = (ModuleNode *)m->tree;
+	PositionObject *function_table[tree->function.count + 1];
+	Code *module_code;
+	Loop l;
+
+	assert(m == reader.current);
+
+	for (int i = 0; i < tree->function.count; i++)
+		function_table[i] = function((FuncDefNode *)tree->function.item[i]);
+
+	begin(m->name);
+	module_code = code;
+
+	for (int i = 0; i < tree->function.count; i++)
+		emit(OP_FUNCTION, code_constant(code, (Object *)function_table[i]), tree->function.item[i]);
+
+	/* break and continue outside a loop end the statement */
+	for (int i = 0; i < tree->statement.count; i++) {
+		loop_enter(&l);
+		statement(tree->statement.item[i]);
+		loop_leave(code->size, code->size);
+	}
+
+	emit(OP_LOAD_CONST, zero, (Node *)tree);
+	emit(OP_RETURN, 0, (Node *)tree);
+
+	thread_jumps(module_code);
+
+	#ifdef DEBUG
+	if (config.debug & DEBUGCODE) {
+		for (int i = 0; i < tree->function.count; i++)
+			code_dump(function_table[i]->code);
+		code_dump(module_code);
+	}
+	#endif  /* DEBUG */
+
+	return module_code;
+}
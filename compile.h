@@ -0,0 +1,13 @@
+/* compile.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _COMPILE_
+#define _COMPILE_
+
+#include "module.h"
+#include "code.h"
+
+extern Code *compile(Module *m);
+
+#endif
@@ -1,524 +1,428 @@
-/* expression.c
- *
- * Expression evaluator
- *
- * Recursively evaluate an expression in the following order:
- *
- * - first variables (including subscripts and slices) and constants,
- *   then function calls, object methods and parenthesized expressions,
- * - then the unary operators + - and !
- * - then multiplication and division (normal and modulo)
- * - then addition and subtraction
- * - then the comparisons < <= > and >=
- * - then the comparisons == and !=
- * - then logical and
- * - then logical or
- * - then assignment of values (normal and compound)
- * - and finally comma separated statements
- *
- * The outcome is an object which contains the result.
- *
- * 1995 K.W.E. de Lange
- */
-#include <limits.h>
-#include <string.h>
-
-#include "expression.h"
-#include "identifier.h"
-#include "position.h"
-#include "function.h"
-#include "scanner.h"
-#include "parser.h"
-#include "error.h"
-#include "str.h"
-
-
-static Object *logical_or_expr(void);
-
-
-/* Decode the next expression and convert the result to an integer.
- *
- * Used when subscript indices must be read.
- */
-static int_t int_expression(void)
-{
-	Object *obj;
-	int_t i;
-
-	obj = logical_or_expr();
-	i = obj_as_int(obj);
-	obj_decref(obj);
-
-	return i;
-}
-
-
-/* Decode subscripts [index] and [start:end] for sequences.
- *
- * Index is mandatory, start and end are optional. The result can be another
- * sequence with subscripts. Decoding continues until no subscripts are left.
- *
- * The opening LSQB of the subscript has already been read.
- *
- * Return: new reference (count = 1)
- *         for LIST: LISTNODE for index or LIST for slice
- *         for STR: CHAR for index or STR for slice
- */
-static Object *subscript(Object *sequence)
-{
-	Object *lvalue, *rvalue, *original = sequence;
-	enum { INDEX, SLICE } type = INDEX;
-	int_t index = 0, start = 0, end = 0;
-
-	if (!isSequence(sequence))
-		error(TypeError, "%s is not subscriptable", TYPENAME(sequence));
-
-	rvalue = sequence;
-
-	while (1) {
-		sequence = isListNode(rvalue) ? obj_from_listnode(rvalue) : rvalue;
-
-		type = INDEX;
-
-		if (accept(COLON)) {
-			start = 0;
-			type = SLICE;
-		} else {
-			start = index = int_expression();
-		}
-		if (accept(COLON)) {
-			type = SLICE;
-		}
-		if (accept(RSQB)) {
-			if (type == SLICE)
-				end = INT_MAX;
-		} else {
-			end = int_expression();
-			expect(RSQB);
-		}
-		if (type == INDEX)
-			lvalue = obj_item((Object *)sequence, index);
-		else
-			lvalue = obj_slice((Object *)sequence, start, end);
-
-		if (lvalue == NULL)
-			error(IndexError);
-
-		if (accept(LSQB)) {
-			if (rvalue != original)
-				obj_decref(rvalue);
-			rvalue = lvalue;
-		} else
-			break;
-	}
-	return lvalue;
-}
-
-
-/* Call methods: seq.len, seq.append, seq.remove, seq.insert
- *
- * The DOT which indicates a method will follow has already been read.
- *
- * Return: new reference (with count = 1)
- */
-static Object *method(Object *object)
-{
-	int_t index;
-	Object *obj = NULL;
-
-	object = isListNode(object) ? obj_from_listnode(object) : object;
-
-	/* If an object has many methods then the approach used below is not
-	 * very efficient and must be rewritten. */
-	if (scanner.token == IDENTIFIER) {
-		if (TYPE(object) == LIST_T && strcmp("insert", scanner.string) == 0) {
-			expect(IDENTIFIER);
-			expect(LPAR);
-			index = int_expression();
-			expect(COMMA);
-			obj = logical_or_expr();
-			listtype.insert((ListObject *)object, index, obj_copy(obj));
-			obj_decref(obj);
-			obj = obj_alloc(NONE_T);
-			expect(RPAR);
-		} else if (TYPE(object) == LIST_T && strcmp("append", scanner.string) == 0) {
-			expect(IDENTIFIER);
-			expect(LPAR);
-			obj = logical_or_expr();
-			listtype.append((ListObject *)object, obj_copy(obj));
-			obj_decref(obj);
-			obj = obj_alloc(NONE_T);
-			expect(RPAR);
-		} else if (TYPE(object) == LIST_T && strcmp("remove", scanner.string) == 0) {
-			expect(IDENTIFIER);
-			expect(LPAR);
-			index = int_expression();
-			if ((obj = listtype.remove((ListObject *)object, index)) == NULL)
-				error(IndexError);
-			expect(RPAR);
-		} else if (TYPE(object) == LIST_T && strcmp("len", scanner.string) == 0) {
-			expect(IDENTIFIER);
-			obj = listtype.length((ListObject *)object);
-		} else if (TYPE(object) == STR_T && strcmp("len", scanner.string) == 0) {
-			expect(IDENTIFIER);
-			obj = strtype.length((StrObject *)object);// str_length((StrObject *)object);
-		} else
-			error(SyntaxError, "unknown method %s for type %s", scanner.string, TYPENAME(object));
-	} else
-		error(SyntaxError, "expected method for type %s", TYPENAME(object));
-
-	return obj;
-}
-
-
-/* Evaluate the part of an expression which comes after the identifier,
- * function call or constant.
- *
- * Contains: subscripts and methods. Methods may follow subscripts:
- * e.g. "abc"[:].len returns 3
- *
- * Return: obj (reference count not increased) if there is no trailer, or
- *         new reference (count = 1)
- */
-static Object *trailer(Object *obj)
-{
-	Object *rv = NULL;
-
-	if (accept(LSQB)) {  /* is subscript */
-		rv = subscript(obj);
-		obj_decref(obj);
-		obj = rv;
-	}
-	if (accept(DOT)) {  /* is method */
-		rv = method(obj);
-		obj_decref(obj);
-	}
-	if (rv == NULL)  /* neither a subscript nor a method */
-		rv = obj;
-
-	return rv;
-}
-
-
-/* Evaluate variables, function calls, constants, (expression)
- *
- * Return: object with reference count +1
- */
-static Object *primary_expr(void)
-{
-	Identifier *id;
-	Object *obj = NULL, *tmp;
-
-	switch (scanner.token) {
-		case CHAR:  /* CHAR constant */
-			obj = obj_create(CHAR_T, str_to_char(scanner.string));
-			expect(CHAR);
-			break;
-		case INT:   /* INT constant */
-			obj = obj_create(INT_T, str_to_int(scanner.string));
-			expect(INT);
-			break;
-		case FLOAT:  /* FLOAT constant */
-			obj = obj_create(FLOAT_T, str_to_float(scanner.string));
-			expect(FLOAT);
-			break;
-		case STR:   /* STR constant */
-			obj = obj_create(STR_T, scanner.string);
-			expect(STR);
-			break;
-		case LSQB:  /* LIST constant */
-			obj = obj_alloc(LIST_T);
-			expect(LSQB);
-			while (accept(RSQB) == 0) {
-				do {
-					tmp = assignment_expr();
-					listtype.append((ListObject *)obj, obj_copy(tmp));
-					obj_decref(tmp);
-				} while (accept(COMMA));
-			}
-			break;
-		case IDENTIFIER:  /* variabele or function identifier */
-			/* precedence rule: user defined identifiers shadow builtins */
-			if ((id = identifier.search(scanner.string)) == NULL) {
-				if ((obj = builtin(scanner.string)) != NULL)
-					break;
-				else
-					error(NameError, "identifier %s is not defined", scanner.string);
-			}
-			expect(IDENTIFIER);
-			if (TYPE(id->object) == POSITION_T) {
-				obj = function_call((PositionObject *)id->object);
-			} else {
-				obj = id->object;
-				obj_incref(obj);
-			}
-			break;
-		case LPAR:  /* parenthesized expression */
-			expect(LPAR);
-			obj = comma_expr();
-			expect(RPAR);
-			break;
-		default:
-			error(SyntaxError, "expression expected");
-	}
-	return trailer(obj);
-}
-
-
-/* Operators: (unary)-  (unary)+  ! (logical negation, NOT)
- */
-static Object *unary_expr(void)
-{
-	Object *lvalue, *result;
-
-	if (accept(NOT)) {
-		result = primary_expr();
-		lvalue = obj_negate(result);
-		obj_decref(result);
-	} else if (accept(MINUS)) {
-		result = primary_expr();
-		lvalue = obj_invert(result);
-		obj_decref(result);
-	} else if (accept(PLUS)) {
-		lvalue = primary_expr();
-	} else
-		lvalue = primary_expr();
-
-	return lvalue;
-}
-
-
-/* Operators: *  /  %
- */
-static Object *mult_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = unary_expr();
-
-	while (1)
-		if (accept(STAR)) {
-			rvalue = unary_expr();
-			result = obj_mult(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(SLASH)) {
-			rvalue = unary_expr();
-			result = obj_divs(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(PERCENT)) {
-			rvalue = unary_expr();
-			result = obj_mod(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: +  -
- */
-static Object *additive_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = mult_expr();
-
-	while (1)
-		if (accept(PLUS)) {
-			rvalue = mult_expr();
-			result = obj_add(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(MINUS)) {
-			rvalue = mult_expr();
-			result = obj_sub(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: <  <=  >  >=
- */
-static Object *relational_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = additive_expr();
-
-	while (1)
-		if (accept(LESS)) {
-			rvalue = relational_expr();
-			result = obj_lss(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(LESSEQUAL)) {
-			rvalue = relational_expr();
-			result = obj_leq(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(GREATER)) {
-			rvalue = relational_expr();
-			result = obj_gtr(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(GREATEREQUAL)) {
-			rvalue = relational_expr();
-			result = obj_geq(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: ==  !=  <>  in
- */
-static Object *equality_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = relational_expr();
-
-	while (1)
-		if (accept(EQEQUAL)) {
-			rvalue = equality_expr();
-			result = obj_eql(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(NOTEQUAL)) {
-			rvalue = equality_expr();
-			result = obj_neq(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else if (accept(IN)) {
-			rvalue = equality_expr();
-			result = obj_in(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: logical and
- */
-static Object *logical_and_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = equality_expr();
-
-	while (1)
-		if (accept(AND)) {
-			rvalue = logical_and_expr();
-			result= obj_and(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: logical or
- */
-static Object *logical_or_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = logical_and_expr();
-
-	while (1)
-		if (accept(OR)) {
-			rvalue = logical_or_expr();
-			result = obj_or(lvalue, rvalue);
-			obj_decref(lvalue);
-			obj_decref(rvalue);
-			lvalue = result;
-		} else
-			return lvalue;
-}
-
-
-/* Operators: =  +=  -=  *=  /=  %=
- */
-Object *assignment_expr(void)
-{
-	Object *lvalue, *rvalue, *result;
-
-	lvalue = logical_or_expr();
-
-	while (1)
-		if (accept(EQUAL)) {
-			rvalue = assignment_expr();
-			obj_assign(lvalue, rvalue);
-			obj_decref(rvalue);
-		} else if (accept(PLUSEQUAL)) {
-			rvalue = logical_or_expr();
-			result = obj_add(lvalue, rvalue);
-			obj_assign(lvalue, result);
-			obj_decref(rvalue);
-			obj_decref(result);
-		} else if (accept(MINUSEQUAL)) {
-			rvalue = logical_or_expr();
-			result = obj_sub(lvalue, rvalue);
-			obj_assign(lvalue, result);
-			obj_decref(rvalue);
-			obj_decref(result);
-		} else if (accept(STAREQUAL)) {
-			rvalue = logical_or_expr();
-			result = obj_mult(lvalue, rvalue);
-			obj_assign(lvalue, result);
-			obj_decref(rvalue);
-			obj_decref(result);
-		} else if (accept(SLASHEQUAL)) {
-			rvalue = logical_or_expr();
-			result = obj_divs(lvalue, rvalue);
-			obj_assign(lvalue, result);
-			obj_decref(rvalue);
-			obj_decref(result);
-		} else if (accept(PERCENTEQUAL)) {
-			rvalue = logical_or_expr();
-			result = obj_mod(lvalue, rvalue);
-			obj_assign(lvalue, result);
-			obj_decref(rvalue);
-			obj_decref(result);
-		} else
-			return lvalue;
-}
-
-
-/* Operators: ,
- *
- * Multiple expressions separated by comma's. Returns an object with the
- * result from the last expression.
- */
-Object *comma_expr(void)
-{
-	Object *lvalue;
-
-	lvalue = assignment_expr();
-
-	while (1)
-		if (accept(COMMA)) {
-			obj_decref(lvalue);
-			lvalue = comma_expr();
-		} else
-			return lvalue;
-}
+/* expression.c
+ *
+ * Expression parser
+ *
+ * Recursively decode an expression in the following order:
+ *
+ * - first variables (including subscripts and slices) and constants,
+ *   then function calls, object methods and parenthesized expressions,
+ * - then the unary operators + - and !
+ * - then multiplication and division (normal and modulo)
+ * - then addition and subtraction
+ * - then the comparisons < <= > and >=
+ * - then the comparisons == and !=
+ * - then logical and
+ * - then logical or
+ * - then assignment of values (normal and compound)
+ * - and finally comma separated statements
+ *
+ * The outcome is a tree of nodes which represents the expression. The
+ * tree is evaluated by eval.c.
+ *
+ * 1995 K.W.E. de Lange
+ */
+#include <string.h>
+
+#include "expression.h"
+#include "scanner.h"
+#include "parser.h"
+#include "error.h"
+#include "str.h"
+
+
+static Node *logical_or_expr(void);
+
+
+/* Create a node for a binary operator.
+ */
+static Node *binary(token_t operator, Node *left, Node *right)
+{
+	BinaryNode *node = NODE(BinaryNode, BINARY_N);
+
+	node->operator = operator;
+	node->left = left;
+	node->right = right;
+
+	return (Node *)node;
+}
+
+
+/* Decode subscripts [index] and [start:end] for sequences.
+ *
+ * Index is mandatory, start and end are optional. The result can be another
+ * sequence with subscripts. Decoding continues until no subscripts are left.
+ *
+ * The opening LSQB of the subscript has already been read.
+ */
+static Node *subscript(Node *sequence)
+{
+	IndexNode *index;
+	SliceNode *slice;
+	Node *start;
+
+	while (1) {
+		start = NULL;
+
+		if (scanner.token != COLON)
+			start = logical_or_expr();
+
+		if (accept(COLON)) {
+			slice = NODE(SliceNode, SLICE_N);
+			slice->sequence = sequence;
+			slice->start = start;
+			if (accept(RSQB) == 0) {
+				slice->end = logical_or_expr();
+				expect(RSQB);
+			}
+			sequence = (Node *)slice;
+		} else {
+			expect(RSQB);
+			index = NODE(IndexNode, INDEX_N);
+			index->sequence = sequence;
+			index->index = start;
+			sequence = (Node *)index;
+		}
+		if (accept(LSQB) == 0)
+			break;
+	}
+	return sequence;
+}
+
+
+/* Decode methods: seq.len, seq.append, seq.remove, seq.insert
+ *
+ * The DOT which indicates a method will follow has already been read.
+ * Whether the object actually supports the method is checked when the
+ * expression is evaluated.
+ */
+static Node *method(Node *object)
+{
+	MethodNode *node = NODE(MethodNode, METHOD_N);
+
+	node->object = object;
+
+	if (scanner.token != IDENTIFIER)
+		error(SyntaxError, "expected method instead of %s", tokenName(scanner.token));
+
+	node->name = scanner.string;
+
+	if (strcmp("insert", scanner.string) == 0) {
+		node->method = INSERT_M;
+		expect(IDENTIFIER);
+		expect(LPAR);
+		nodelist_append(&node->argument, logical_or_expr());
+		expect(COMMA);
+		nodelist_append(&node->argument, logical_or_expr());
+		expect(RPAR);
+	} else if (strcmp("append", scanner.string) == 0) {
+		node->method = APPEND_M;
+		expect(IDENTIFIER);
+		expect(LPAR);
+		nodelist_append(&node->argument, logical_or_expr());
+		expect(RPAR);
+	} else if (strcmp("remove", scanner.string) == 0) {
+		node->method = REMOVE_M;
+		expect(IDENTIFIER);
+		expect(LPAR);
+		nodelist_append(&node->argument, logical_or_expr());
+		expect(RPAR);
+	} else if (strcmp("len", scanner.string) == 0) {
+		node->method = LEN_M;
+		expect(IDENTIFIER);
+	} else {
+		node->method = UNKNOWN_M;
+		expect(IDENTIFIER);
+	}
+	return (Node *)node;
+}
+
+
+/* Decode the part of an expression which comes after the identifier,
+ * function call or constant.
+ *
+ * Contains: subscripts and methods. Methods may follow subscripts:
+ * e.g. "abc"[:].len returns 3
+ */
+static Node *trailer(Node *node)
+{
+	if (accept(LSQB))  /* is subscript */
+		node = subscript(node);
+	if (accept(DOT))  /* is method */
+		node = method(node);
+
+	return node;
+}
+
+
+/* Decode the arguments of a function call.
+ *
+ * in:  token = LPAR of argument list
+ * out: token = token after RPAR of argument list
+ */
+static void arguments(NodeList *list)
+{
+	expect(LPAR);
+
+	while (scanner.token != RPAR) {
+		nodelist_append(list, assignment_expr());
+		if (scanner.token == RPAR)
+			continue;
+		else
+			expect(COMMA);
+	}
+	expect(RPAR);
+}
+
+
+/* Decode variables, function calls, constants, (expression)
+ */
+static Node *primary_expr(void)
+{
+	ConstantNode *constant;
+	ListExprNode *list;
+	NameNode *name;
+	CallNode *call;
+	Node *node = NULL;
+	char *identifier;
+
+	switch (scanner.token) {
+		case CHAR:  /* CHAR constant */
+			constant = NODE(ConstantNode, CONSTANT_N);
+			constant->value = chartype.value(str_to_char(scanner.string));
+			node = (Node *)constant;
+			expect(CHAR);
+			break;
+		case INT:   /* INT constant */
+			constant = NODE(ConstantNode, CONSTANT_N);
+			constant->value = inttype.value(str_to_int(scanner.string));
+			node = (Node *)constant;
+			expect(INT);
+			break;
+		case FLOAT:  /* FLOAT constant */
+			constant = NODE(ConstantNode, CONSTANT_N);
+			constant->value = obj_create(FLOAT_T, str_to_float(scanner.string));
+			node = (Node *)constant;
+			expect(FLOAT);
+			break;
+		case STR:   /* STR constant */
+			constant = NODE(ConstantNode, CONSTANT_N);
+			constant->value = (Object *)strtype.share((StrObject *)obj_alloc(STR_T), scanner.string);
+			node = (Node *)constant;
+			expect(STR);
+			break;
+		case LSQB:  /* LIST constant */
+			list = NODE(ListExprNode, LISTEXPR_N);
+			expect(LSQB);
+			while (accept(RSQB) == 0) {
+				do {
+					nodelist_append(&list->element, assignment_expr());
+				} while (accept(COMMA));
+			}
+			node = (Node *)list;
+			break;
+		case IDENTIFIER:  /* variabele or function identifier */
+			identifier = scanner.string;  /* peek() changes scanner.string */
+			if (scanner.peek() == LPAR) {
+				call = NODE(CallNode, CALL_N);
+				call->name = identifier;
+				expect(IDENTIFIER);
+				arguments(&call->argument);
+				node = (Node *)call;
+			} else {
+				name = NODE(NameNode, NAME_N);
+				name->name = identifier;
+				expect(IDENTIFIER);
+				node = (Node *)name;
+			}
+			break;
+		case LPAR:  /* parenthesized expression */
+			expect(LPAR);
+			node = comma_expr();
+			expect(RPAR);
+			break;
+		default:
+			error(SyntaxError, "expression expected");
+	}
+	return trailer(node);
+}
+
+
+/* Operators: (unary)-  (unary)+  ! (logical negation, NOT)
+ */
+static Node *unary_expr(void)
+{
+	UnaryNode *node;
+	token_t operator = scanner.token;
+
+	if (accept(NOT) || accept(MINUS)) {
+		node = NODE(UnaryNode, UNARY_N);
+		node->operator = operator;
+		node->operand = primary_expr();
+		return (Node *)node;
+	} else if (accept(PLUS)) {
+		return primary_expr();
+	} else
+		return primary_expr();
+}
+
+
+/* Operators: *  /  %
+ */
+static Node *mult_expr(void)
+{
+	Node *lvalue;
+	token_t operator;
+
+	lvalue = unary_expr();
+
+	while (1) {
+		operator = scanner.token;
+		if (accept(STAR) || accept(SLASH) || accept(PERCENT))
+			lvalue = binary(operator, lvalue, unary_expr());
+		else
+			return lvalue;
+	}
+}
+
+
+/* Operators: +  -
+ */
+static Node *additive_expr(void)
+{
+	Node *lvalue;
+	token_t operator;
+
+	lvalue = mult_expr();
+
+	while (1) {
+		operator = scanner.token;
+		if (accept(PLUS) || accept(MINUS))
+			lvalue = binary(operator, lvalue, mult_expr());
+		else
+			return lvalue;
+	}
+}
+
+
+/* Operators: <  <=  >  >=
+ */
+static Node *relational_expr(void)
+{
+	Node *lvalue;
+	token_t operator;
+
+	lvalue = additive_expr();
+
+	while (1) {
+		operator = scanner.token;
+		if (accept(LESS) || accept(LESSEQUAL) || accept(GREATER) || accept(GREATEREQUAL))
+			lvalue = binary(operator, lvalue, relational_expr());
+		else
+			return lvalue;
+	}
+}
+
+
+/* Operators: ==  !=  <>  in
+ */
+static Node *equality_expr(void)
+{
+	Node *lvalue;
+	token_t operator;
+
+	lvalue = relational_expr();
+
+	while (1) {
+		operator = scanner.token;
+		if (accept(EQEQUAL) || accept(NOTEQUAL) || accept(IN))
+			lvalue = binary(operator, lvalue, equality_expr());
+		else
+			return lvalue;
+	}
+}
+
+
+/* Operators: logical and
+ */
+static Node *logical_and_expr(void)
+{
+	Node *lvalue;
+
+	lvalue = equality_expr();
+
+	while (1)
+		if (accept(AND))
+			lvalue = binary(AND, lvalue, logical_and_expr());
+		else
+			return lvalue;
+}
+
+
+/* Operators: logical or
+ */
+static Node *logical_or_expr(void)
+{
+	Node *lvalue;
+
+	lvalue = logical_and_expr();
+
+	while (1)
+		if (accept(OR))
+			lvalue = binary(OR, lvalue, logical_or_expr());
+		else
+			return lvalue;
+}
+
+
+/* Operators: =  +=  -=  *=  /=  %=
+ */
+Node *assignment_expr(void)
+{
+	AssignNode *node;
+	Node *lvalue;
+	token_t operator;
+
+	lvalue = logical_or_expr();
+
+	while (1) {
+		operator = scanner.token;
+		if (accept(EQUAL)) {
+			node = NODE(AssignNode, ASSIGN_N);
+			node->operator = operator;
+			node->target = lvalue;
+			node->value = assignment_expr();
+			lvalue = (Node *)node;
+		} else if (accept(PLUSEQUAL) || accept(MINUSEQUAL) || accept(STAREQUAL) || \
+				   accept(SLASHEQUAL) || accept(PERCENTEQUAL)) {
+			node = NODE(AssignNode, ASSIGN_N);
+			node->operator = operator;
+			node->target = lvalue;
+			node->value = logical_or_expr();
+			lvalue = (Node *)node;
+		} else
+			return lvalue;
+	}
+}
+
+
+/* Operators: ,
+ *
+ * Multiple expressions separated by comma's. The result is the result
+ * from the last expression.
+ */
+Node *comma_expr(void)
+{
+	CommaNode *node;
+	Node *lvalue;
+
+	lvalue = assignment_expr();
+
+	while (1)
+		if (accept(COMMA)) {
+			node = NODE(CommaNode, COMMA_N);
+			node->left = lvalue;
+			node->right = comma_expr();
+			lvalue = (Node *)node;
+		} else
+			return lvalue;
+}
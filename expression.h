@@ -1,13 +1,13 @@
-/* expression.h
- *
- * 1995 K.W.E. de Lange
- */
-#ifndef _EXPRESSION_
-#define _EXPRESSION_
-
-#include "object.h"
-
-extern Object *comma_expr(void);
-extern Object *assignment_expr(void);
-
-#endif
+/* expression.h
+ *
+ * 1995 K.W.E. de Lange
+ */
+#ifndef _EXPRESSION_
+#define _EXPRESSION_
+
+#include "ast.h"
+
+extern Node *comma_expr(void);
+extern Node *assignment_expr(void);
+
+#endif
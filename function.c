@@ -1,125 +1,242 @@
-/* function.c
- *
- * Builtin (aka intrinsic) functions.
- *
- * 2019	K.W.E. de Lange
- */
-#include <string.h>
-#include "error.h"
-#include "function.h"
-
-
-/* Builtin: determine the type of an expression
- *
- * in:	token = LPAR of argument list
- * out:	token = token after RPAR of function call argument list
- *
- * Syntax: type(expression)
- */
-static Object *type(void)
-{
-	Object *obj, *result;
-
-	expect(LPAR);
-	obj = assignment_expr();
-	expect(RPAR);
-
-	result = isListNode(obj) ? obj_type(obj_from_listnode(obj)) : obj_type(obj);
-
-	obj_decref(obj);
-
-	return result;
-}
-
-
-/* Builtin: return ASCII character (as string) representation of integer
- *
- * in:	token = LPAR of argument list
- * out:	token = token after RPAR of function call argument list
- *
- * Syntax: chr(integer expression)
- */
-static Object *chr(void)
-{
-	Object *obj, *result;
-	char buffer[BUFSIZE+1];
-
-	expect(LPAR);
-	obj = assignment_expr();
-	expect(RPAR);
-
-	snprintf(buffer, BUFSIZE, "%c", obj_as_char(obj));
-	result = obj_create(STR_T, buffer);
-
-	obj_decref(obj);
-
-	return result;
-}
-
-
-/* Builtin: return integer representation of ASCII character (in string)
- *
- * in:	token = LPAR of argument list
- * out:	token = token after RPAR of function call argument list
- *
- * Syntaxt: ord(string expression)
- */
-static Object *ord(void)
-{
-	Object *obj, *result;
-
-	expect(LPAR);
-	obj = assignment_expr();
-	expect(RPAR);
-
-	if (TYPE(obj) != STR_T)
-		error(TypeError, "expected string but found %s", TYPENAME(obj));
-
-	result = obj_create(INT_T, (int_t)obj_as_char(obj));
-	obj_decref(obj);
-
-	return result;
-}
-
-
-/*	Table containing all builtin function names and their addresses.
- */
-static struct {
-	char *functionname;
-	Object *(*functionaddr)();
-} builtinTable[] = { /* Note: functionnames must be sorted alphabetically */
-	{"chr", chr},
-	{"ord", ord},
-	{"type", type}
-};
-
-
-/* Check if functionname is an builtin function, and if so execute it.
- *
- * functionname	identifier to check for builtin function
- * return		Object* with function results if functionname
- * 				was a builtin else NULL
- */
-Object *builtin(char *functionname)
-{
-	int l, h, m, d;
-
-	l = 0, h = (int)(sizeof builtinTable / sizeof builtinTable[0]) - 1;
-
-	while (l <= h) {
-		m = (l + h) / 2;
-		d = strcmp(&functionname[0], builtinTable[m].functionname);
-		if (d < 0)
-			h = m - 1;
-		if (d > 0)
-			l = m + 1;
-		if (d == 0)
-			break;
-	};
-
-	if (d == 0) {
-		expect(IDENTIFIER);
-		return builtinTable[m].functionaddr();  /* call */
-	} else
-		return NULL;
-}
+/* function.c
+ *
+ * Builtin (aka intrinsic) functions.
+ *
+ * Every builtin receives its arguments as an array of already evaluated
+ * objects. The caller remains owner of the arguments.
+ *
+ * 2019	K.W.E. de Lange
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "output.h"
+#include "error.h"
+#include "function.h"
+#include "number.h"
+#include "lines.h"
+#include "str.h"
+
+#define CHUNKSIZE	65536		/* initial number of bytes read at once */
+
+
+/* Check if a builtin was called with exactly one argument.
+ */
+static void one_argument(const char *functionname, int argc)
+{
+	if (argc != 1)
+		error(TypeError, "%s() takes exactly one argument (%d given)", \
+						  functionname, argc);
+}
+
+
+/* Check if a builtin was called with no or one argument.
+ */
+static void optional_argument(const char *functionname, int argc)
+{
+	if (argc > 1)
+		error(TypeError, "%s() takes at most one argument (%d given)", \
+						  functionname, argc);
+}
+
+
+/* Read everything from the file named in the first argument, or from
+ * stdin if there are no arguments. The file is read in large chunks, the
+ * buffer doubles in size when it is full.
+ *
+ * len		is set to the number of bytes read
+ * return	buffer with the text (not '\0' terminated), free() after use
+ */
+static char *read_all(int argc, Object *argv[], size_t *len)
+{
+	size_t capacity = CHUNKSIZE, n;
+	char *buffer, *b;
+	char *filename;
+	FILE *fp;
+
+	if (argc == 0) {
+		fp = stdin;
+		output_flush();  /* show everything printed so far, e.g. a prompt */
+	} else if ((fp = fopen(filename = obj_as_str(argv[0]), "r")) == NULL)
+		error(SystemError, "cannot open %s: %s (%d)", filename, strerror(errno), errno);
+
+	if ((buffer = malloc(capacity)) == NULL)
+		error(OutOfMemoryError);
+
+	*len = 0;
+
+	while ((n = fread(buffer + *len, sizeof(char), capacity - *len, fp)) > 0) {
+		*len += n;
+		if (*len == capacity) {
+			if ((b = realloc(buffer, capacity * 2)) == NULL)
+				error(OutOfMemoryError);
+			buffer = b;
+			capacity *= 2;
+		}
+	}
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return buffer;
+}
+
+
+/* Builtin: read a complete file, or everything from stdin, into a string
+ *
+ * Syntax: read([filename])
+ */
+static Object *readall(int argc, Object *argv[])
+{
+	StrObject *obj;
+	char *buffer;
+	size_t len;
+
+	optional_argument("read", argc);
+
+	buffer = read_all(argc, argv, &len);
+
+	obj = strtype.set_n((StrObject *)obj_alloc(STR_T), buffer, len);
+
+	free(buffer);
+
+	return (Object *)obj;
+}
+
+
+/* Builtin: read all lines of a file, or from stdin, into a list of strings
+ * without line ends
+ *
+ * Syntax: readlines([filename])
+ */
+static Object *readlines(int argc, Object *argv[])
+{
+	ListObject *list;
+	char *buffer, *line, *end, *eol;
+	size_t len;
+
+	optional_argument("readlines", argc);
+
+	buffer = read_all(argc, argv, &len);
+
+	list = (ListObject *)obj_alloc(LIST_T);
+
+	for (line = buffer, end = buffer + len; line < end; line = eol + 1) {
+		if ((eol = memchr(line, '\n', end - line)) == NULL)
+			eol = end;  /* last line has no line end */
+		len = eol - line;
+		if (len && line[len - 1] == '\r')
+			len--;
+		listtype.append(list, (Object *)strtype.set_n((StrObject *)obj_alloc(STR_T), line, len));
+	}
+
+	free(buffer);
+
+	return (Object *)list;
+}
+
+
+/* Builtin: iterate over the lines of a file, or from stdin, in a for loop
+ * without reading them all first (see lines.c)
+ *
+ * Syntax: lines([filename])
+ */
+static Object *lines(int argc, Object *argv[])
+{
+	optional_argument("lines", argc);
+
+	return obj_create(LINES_T, argc ? obj_as_str(argv[0]) : NULL);
+}
+
+
+/* Builtin: determine the type of an expression
+ *
+ * Syntax: type(expression)
+ */
+static Object *type(int argc, Object *argv[])
+{
+	Object *obj;
+
+	one_argument("type", argc);
+
+	obj = argv[0];
+
+	return isListNode(obj) ? obj_type(obj_from_listnode(obj)) : obj_type(obj);
+}
+
+
+/* Builtin: return ASCII character (as string) representation of integer
+ *
+ * Syntax: chr(integer expression)
+ */
+static Object *chr(int argc, Object *argv[])
+{
+	char buffer[BUFSIZE+1];
+
+	one_argument("chr", argc);
+
+	snprintf(buffer, BUFSIZE, "%c", obj_as_char(argv[0]));
+
+	return obj_create(STR_T, buffer);
+}
+
+
+/* Builtin: return integer representation of ASCII character (in string)
+ *
+ * Syntaxt: ord(string expression)
+ */
+static Object *ord(int argc, Object *argv[])
+{
+	Object *obj;
+
+	one_argument("ord", argc);
+
+	obj = argv[0];
+
+	if (TYPE(obj) != STR_T)
+		error(TypeError, "expected string but found %s", TYPENAME(obj));
+
+	return inttype.value((int_t)obj_as_char(obj));
+}
+
+
+/*	Table containing all builtin function names and their addresses.
+ */
+static struct {
+	char *functionname;
+	builtin_t functionaddr;
+} builtinTable[] = { /* Note: functionnames must be sorted alphabetically */
+	{"chr", chr},
+	{"lines", lines},
+	{"ord", ord},
+	{"read", readall},
+	{"readlines", readlines},
+	{"type", type}
+};
+
+
+/* Check if functionname is an builtin function.
+ *
+ * functionname	identifier to check for builtin function
+ * return		address of the builtin function if functionname
+ * 				was a builtin else NULL
+ */
+builtin_t builtin(const char *functionname)
+{
+	int l, h, m, d;
+
+	l = 0, h = (int)(sizeof builtinTable / sizeof builtinTable[0]) - 1;
+
+	while (l <= h) {
+		m = (l + h) / 2;
+		d = strcmp(&functionname[0], builtinTable[m].functionname);
+		if (d < 0)
+			h = m - 1;
+		if (d > 0)
+			l = m + 1;
+		if (d == 0)
+			return builtinTable[m].functionaddr;
+	};
+
+	return NULL;
+}
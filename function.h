@@ -1,13 +1,14 @@
-/* function.h
- *
- * 2019	K.W.E. de Lange
- */
-#ifndef _FUNCTION_
-#define _FUNCTION_
-
-#include "expression.h"
-#include "parser.h"
-
-Object *builtin(char *functionname);
-
-#endif
+/* function.h
+ *
+ * 2019	K.W.E. de Lange
+ */
+#ifndef _FUNCTION_
+#define _FUNCTION_
+
+#include "object.h"
+
+typedef Object *(*builtin_t)(int argc, Object *argv[]);
+
+extern builtin_t builtin(const char *functionname);
+
+#endif
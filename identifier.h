@@ -1,43 +1,37 @@
-/* identifier.h
- *
- * 1994	K.W.E. de Lange
- */
-#ifndef _IDENTIFIER_
-#define _IDENTIFIER_
-
-#include "object.h"
-
-typedef struct identifier {
-	char *name;
-	struct identifier *next;
-	struct object *object;
-
-	struct identifier *(*add)(const char *name);
-	struct identifier *(*search)(const char *name);
-	void (*bind)(struct identifier *self, Object *o);
-	void (*unbind)(struct identifier *self);
-} Identifier;
-
-extern Identifier identifier;
-
-typedef struct scope {
-	struct scope *parent;
-	Identifier *first;
-	int indentlevel;
-	int indentation[MAXINDENT];
-
-	void (*append_level)(void);
-	void (*remove_level)(void);
-} Scope;
-
-extern Scope scope;
-
-#define SCOPE_INIT { .parent = NULL, \
-                     .first = NULL, \
-                     .indentlevel = 0, \
-                     .indentation[0] = 0 }
-
-extern Scope *local;
-
-#endif
-
+/* identifier.h
+ *
+ * 1994	K.W.E. de Lange
+ */
+#ifndef _IDENTIFIER_
+#define _IDENTIFIER_
+
+#include "object.h"
+
+/* An identifier is a slot which binds a name to an object. An identifier
+ * which is not declared yet has no object.
+ */
+typedef struct identifier {
+	char *name;
+	struct object *object;		/* NULL if not declared */
+} Identifier;
+
+/* This struct is the API to the scopes, containing both data and
+ * function adresses.
+ *
+ * Global identifiers are stored in array 'global'; the index of an
+ * identifier is its slot number. Local identifiers are stored in an
+ * array which is owned by the function call (see vm.c).
+ */
+typedef struct scope {
+	Identifier *global;			/* global identifiers, indexed by slot */
+	int size;					/* number of global slots in use */
+	int capacity;				/* number of global slots allocated */
+
+	int (*slot)(char *name);
+	void (*bind)(Identifier *self, Object *o);
+	void (*unbind)(Identifier *self);
+} Scope;
+
+extern Scope scope;
+
+#endif
@@ -0,0 +1,180 @@
+/* intern.c
+ *
+ * String interning.
+ *
+ * Every distinct text is stored only once. Interning a text returns a
+ * pointer to this single copy, so two interned strings are equal if and
+ * only if their pointers are equal. Interned strings are immutable and
+ * remain available during the lifetime of the interpreter.
+ *
+ * The text of an interned string is preceded by its length and hash value,
+ * so these never have to be calculated again. Strings are allocated from
+ * large blocks of memory (an arena) and are found via an open addressing
+ * hash table.
+ *
+ * Only text which is known before execution is interned: names, literals,
+ * module names and type names.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "error.h"
+
+#define BLOCKSIZE	65536		/* number of bytes in an arena block */
+
+
+typedef struct string {
+	size_t length;				/* number of characters, excluding '\0' */
+	unsigned int hash;
+	char text[];
+} String;
+
+#define HEADER(s)	((String *)((s) - offsetof(String, text)))
+
+
+static String **table = NULL;	/* hash table, NULL = empty entry */
+static size_t tablesize = 0;	/* number of entries, always a power of 2 */
+static size_t count = 0;		/* number of strings in the table */
+
+static char *block = NULL;		/* arena block in use */
+static size_t available = 0;	/* number of free bytes in block */
+
+
+/* Calculate the hash value of a text (FNV-1a).
+ */
+static unsigned int hash(const char *s, size_t length)
+{
+	unsigned int h = 2166136261u;
+
+	while (length--)
+		h = (h ^ (unsigned char)*s++) * 16777619u;
+
+	return h;
+}
+
+
+/* Find the entry in the hash table for a text.
+ *
+ * return   index of the entry which contains the text, or if the text
+ *          is not interned yet, of the empty entry to use for it
+ */
+static size_t probe(const char *s, size_t length, unsigned int h)
+{
+	size_t i, mask = tablesize - 1;
+
+	for (i = h & mask; table[i] != NULL; i = (i + 1) & mask)
+		if (table[i]->hash == h && table[i]->length == length && \
+			memcmp(table[i]->text, s, length) == 0)
+			break;
+
+	return i;
+}
+
+
+/* Double the size of the hash table and reinsert all strings.
+ */
+static void grow(void)
+{
+	String **old = table;
+	size_t oldsize = tablesize;
+
+	tablesize = tablesize ? tablesize * 2 : 1024;
+
+	if ((table = calloc(tablesize, sizeof(String *))) == NULL)
+		error(OutOfMemoryError);
+
+	for (size_t i = 0; i < oldsize; i++)
+		if (old[i] != NULL)
+			table[probe(old[i]->text, old[i]->length, old[i]->hash)] = old[i];
+
+	free(old);
+}
+
+
+/* Allocate memory for a string from the arena. Strings which are larger
+ * then a quarter block get their own piece of memory.
+ */
+static String *allocate(size_t length)
+{
+	size_t bytes = (offsetof(String, text) + length + 1 + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+	String *s;
+
+	if (bytes > BLOCKSIZE / 4) {
+		if ((s = malloc(bytes)) == NULL)
+			error(OutOfMemoryError);
+		return s;
+	}
+
+	if (bytes > available) {
+		if ((block = malloc(BLOCKSIZE)) == NULL)
+			error(OutOfMemoryError);
+		available = BLOCKSIZE;
+	}
+
+	s = (String *)block;
+	block += bytes;
+	available -= bytes;
+
+	return s;
+}
+
+
+/* Intern the first length characters of a text.
+ *
+ * s        text, does not have to be '\0' terminated
+ * length   number of characters
+ * return   interned string
+ */
+char *intern_n(const char *s, size_t length)
+{
+	unsigned int h = hash(s, length);
+	String *str;
+	size_t i;
+
+	if (2 * (count + 1) > tablesize)  /* keep load factor <= 0.5 */
+		grow();
+
+	if (table[i = probe(s, length, h)] != NULL)
+		return table[i]->text;
+
+	str = allocate(length);
+	str->length = length;
+	str->hash = h;
+	memcpy(str->text, s, length);
+	str->text[length] = '\0';
+
+	table[i] = str;
+	count++;
+
+	return str->text;
+}
+
+
+/* Intern a '\0' terminated text.
+ *
+ * s        text
+ * return   interned string
+ */
+char *intern(const char *s)
+{
+	return intern_n(s, strlen(s));
+}
+
+
+/* Return the length of an interned string.
+ */
+size_t intern_length(const char *s)
+{
+	return HEADER(s)->length;
+}
+
+
+/* Return the hash value of an interned string.
+ */
+unsigned int intern_hash(const char *s)
+{
+	return HEADER(s)->hash;
+}
@@ -0,0 +1,15 @@
+/* intern.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _INTERN_
+#define _INTERN_
+
+#include <stddef.h>
+
+extern char *intern(const char *s);
+extern char *intern_n(const char *s, size_t length);
+extern size_t intern_length(const char *s);
+extern unsigned int intern_hash(const char *s);
+
+#endif
@@ -0,0 +1,154 @@
+/* lines.c
+ *
+ * Lines object operations
+ *
+ * A lines object reads a text file, or stdin, one line at a time. It is
+ * created by builtin lines() and is meant to be iterated over in a for
+ * loop. Every iteration reads the next line, so a file of any size can be
+ * processed without keeping it in memory. Lines can be of any length and
+ * are returned without their line end ("\n" or "\r\n"). The file is closed
+ * when the loop ends.
+ *
+ * When the lines are typed on a terminal the output is flushed before
+ * every line is read, so a prompt is visible. Otherwise, e.g. when stdin
+ * is a pipe, the output stays buffered (see output.c).
+ *
+ * 2020	K.W.E. de Lange
+ */
+#if defined(__unix__) || defined(__APPLE__)
+	#define _DEFAULT_SOURCE  /* getc_unlocked() is not part of C99 */
+	#include <unistd.h>
+	#define GETC(fp)	getc_unlocked(fp)  /* the interpreter has one thread */
+	#define ISATTY(fp)	isatty(fileno(fp))
+#elif defined(_WIN32)
+	#include <io.h>
+	#define GETC(fp)	getc(fp)
+	#define ISATTY(fp)	_isatty(_fileno(fp))
+#else
+	#define GETC(fp)	getc(fp)
+	#define ISATTY(fp)	1  /* unknown, assume a terminal */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "output.h"
+#include "error.h"
+#include "lines.h"
+#include "pool.h"
+
+static Pool pool = POOL("lines", LinesObject);
+
+
+static LinesObject *lines_alloc(void)
+{
+	LinesObject *obj = pool_alloc(&pool);
+
+	obj->type = LINES_T;
+	obj->refcount = 0;
+
+	obj->fp = NULL;
+	obj->interactive = false;
+	obj->buffer = NULL;
+	obj->capacity = 0;
+
+	return obj;
+}
+
+
+static void lines_free(LinesObject *obj)
+{
+	if (obj->fp && obj->fp != stdin)
+		fclose(obj->fp);
+
+	free(obj->buffer);
+
+	pool_free(&pool, obj);
+}
+
+
+static void lines_print(LinesObject *obj)
+{
+	output_write("lines", 5);
+}
+
+
+/* Start reading from file filename, or from stdin if filename is NULL.
+ */
+static LinesObject *lines_set(LinesObject *obj, const char *filename)
+{
+	if (obj->fp && obj->fp != stdin)
+		fclose(obj->fp);
+
+	obj->interactive = false;
+
+	if (filename == NULL) {
+		obj->fp = stdin;
+		obj->interactive = ISATTY(stdin);
+	} else if ((obj->fp = fopen(filename, "r")) == NULL)
+		error(SystemError, "cannot open %s: %s (%d)", filename, strerror(errno), errno);
+
+	return obj;
+}
+
+
+static LinesObject *lines_vset(LinesObject *obj, va_list argp)
+{
+	return lines_set(obj, va_arg(argp, const char *));
+}
+
+
+/* Read the next line.
+ *
+ * return	new string object with the line, NULL if all lines were read
+ */
+static StrObject *lines_next(LinesObject *obj)
+{
+	size_t len = 0;
+	char *b;
+	int c;
+
+	if (obj->fp == NULL)
+		return NULL;
+
+	if (obj->interactive)
+		output_flush();  /* show everything printed so far, e.g. a prompt */
+
+	/* read character by character, so a line may contain '\0' */
+	while ((c = GETC(obj->fp)) != EOF && c != '\n') {
+		if (len == obj->capacity) {
+			obj->capacity = obj->capacity ? obj->capacity * 2 : LINESIZE;
+			if ((b = realloc(obj->buffer, obj->capacity)) == NULL)
+				error(OutOfMemoryError);
+			obj->buffer = b;
+		}
+		obj->buffer[len++] = (char)c;
+	}
+
+	if (c == EOF && len == 0) {  /* end of file */
+		if (obj->fp != stdin)
+			fclose(obj->fp);
+		obj->fp = NULL;
+		return NULL;
+	}
+
+	if (len && obj->buffer[len - 1] == '\r')
+		len--;
+
+	return strtype.set_n((StrObject *)obj_alloc(STR_T), obj->buffer, len);
+}
+
+
+/*	Lines object API.
+ */
+LinesType linestype = {
+	.name = "lines",
+	.alloc = (Object *(*)())lines_alloc,
+	.free = (void (*)(Object *))lines_free,
+	.print = (void (*)(Object *))lines_print,
+	.set = (Object *(*)())lines_set,
+	.vset = (Object *(*)(Object *, va_list))lines_vset,
+
+	.next = lines_next
+	};
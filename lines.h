@@ -0,0 +1,28 @@
+/* lines.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _LINES_
+#define _LINES_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "object.h"
+#include "str.h"
+
+typedef struct {
+	OBJ_HEAD;
+	FILE *fp;			/* file being read, NULL after the last line */
+	bool interactive;	/* fp is stdin and stdin is a terminal */
+	char *buffer;		/* text of the line being read */
+	size_t capacity;	/* number of bytes allocated for buffer */
+} LinesObject;
+
+typedef struct {
+	TYPE_HEAD;
+	StrObject *(*next)(LinesObject *obj);
+} LinesType;
+
+extern LinesType linestype;
+
+#endif
@@ -1,474 +1,538 @@
-/* list.c
- *
- * List object operations
- *
- * See list.h for an explanation of of how lists are structured.
- *
- * 2016 K.W.E. de Lange
- */
-#include <stdlib.h>
-#include <stdbool.h>
-
-#include "object.h"
-#include "error.h"
-
-
-/* Create a new empty list object.
- */
-static ListObject *list_alloc(void)
-{
-	ListObject *list;
-
-	if ((list = calloc(1, sizeof(ListObject))) == NULL)
-		error(OutOfMemoryError);
-
-	list->typeobj = (TypeObject *)&listtype;
-	list->type = LIST_T;
-	list->refcount = 0;
-
-	list->head = NULL;
-	list->tail = NULL;
-
-	return list;
-}
-
-
-/* Free a list object, including all list nodes and referenced objects.
- */
-static void list_free(ListObject *list)
-{
-	Object *obj;
-
-	while ((obj = listtype.remove(list, 0)) != NULL)
-		obj_decref(obj);
-
-	free(list);
-}
-
-
-static void list_print(ListObject *list)
-{
-	printf("[");
-
-	for (ListNode *node = list->head; node; node = node->next) {
-		obj_print(node->obj);
-		if (node->next)
-			printf(",");
-	}
-	printf("]");
-}
-
-
-/* Create a copy of a list.
- *
- * The new list contains new objects (= deep copy).
- */
-static ListObject *list_set(ListObject *dest, ListObject *src)
-{
-	Object *obj;
-
-	if (dest->head != NULL)
-		while ((obj = listtype.remove(dest, 0)) != NULL)
-			obj_decref(obj);
-
-	for (ListNode *node = src->head; node; node = node->next)
-		listtype.append(dest, obj_copy(node->obj));
-
-	return dest;
-}
-
-
-static ListObject *list_vset(ListObject *obj, va_list argp)
-{
-	return list_set(obj, va_arg(argp, ListObject *));
-}
-
-
-/* Create a new empty listnode.
- */
-static ListNode *listnode_alloc(void)
-{
-	ListNode *node;
-
-	if ((node = calloc(1, sizeof(ListNode))) == NULL)
-		error(OutOfMemoryError);
-
-	node->typeobj = (TypeObject *)&listnodetype;
-	node->type = LISTNODE_T;
-	node->refcount = 0;
-
-	node->next = NULL;
-	node->prev = NULL;
-	node->obj = NULL;
-
-	return node;
-}
-
-
-/* Free a listnode, and release the object it references.
- */
-static void listnode_free(ListNode *node)
-{
-	if (node->obj)
-		obj_decref(node->obj);
-
-	free(node);
-}
-
-
-static void listnode_print(ListNode *node)
-{
-	obj_print(node->obj);
-}
-
-
-static ListNode *listnode_set(ListNode *node, Object *obj)
-{
-	if (node->obj)
-		obj_decref(node->obj);
-
-	node->obj = obj;
-
-	return node;
-}
-
-
-static ListNode *listnode_vset(ListNode *node, va_list argp)
-{
-	return listnode_set(node, va_arg(argp, Object *));
-}
-
-
-/* Count the number of listnodes in a list.
- */
-static int_t length(ListObject *list)
-{
-	ListNode *node;
-	int_t i;
-
-	for (i = 0, node = list->head; node; i++, node = node->next)
-		;
-
-	return i;
-}
-
-
-static Object *list_length(ListObject *list)
-{
-	return obj_create(INT_T, length(list));
-}
-
-
-/* Create a new list which contains the objects from op1 and op2.
- */
-static Object *list_concat(ListObject *op1, ListObject *op2)
-{
-	ListObject *list;
-	ListNode *item;
-	int_t i;
-
-	list = (ListObject *)obj_alloc(LIST_T);
-
-	for (i = 0; i < length(op1); i++) {
-		item = listtype.item(op1, i);
-		listtype.append(list, obj_copy(item->obj));
-		obj_decref(item);
-	}
-	for (i = 0; i < length(op2); i++) {
-		item = listtype.item(op2, i);
-		listtype.append(list, obj_copy(item->obj));
-		obj_decref(item);
-	}
-	return (Object *)list;
-}
-
-
-/* Create a new list which contains n times an existing list.
- */
-static Object *list_repeat(Object *op1, Object *op2)
-{
-	ListObject *list;
-	ListNode *item;
-	int_t times;
-
-	Object *s = TYPE(op1) == LIST_T ? op1 : op2;
-	Object *n = TYPE(op1) == LIST_T ? op2 : op1;
-
-	times = obj_as_int(n);
-
-	list = (ListObject *)obj_alloc(LIST_T);
-
-	while (times--)
-		for (int_t i = 0; i < length((ListObject *)s); i++) {
-			item = listtype.item((ListObject *)s, i);
-			listtype.append(list, obj_copy(item->obj));
-			obj_decref(item);
-		}
-
-	return (Object *)list;
-}
-
-
-/* Compare the content of two lists by index (math: tuple).
- */
-static bool list_cmp(ListObject *op1, ListObject *op2)
-{
-	bool equal;
-	Object *obj;
-	int_t i, l1;
-	ListNode *item1, *item2;
-
-	l1 = length(op1);
-
-	if (l1 != length(op2))
-		return false;  /* the lists should at least be of equal length */
-
-	for (equal = true, i = 0; i < l1; i++) {
-		item1 = listtype.item(op1, i);
-		item2 = listtype.item(op2, i);
-		obj = obj_eql((Object *)item1, (Object *)item2);
-		equal = obj_as_bool(obj);
-		obj_decref(item1);
-		obj_decref(item2);
-		obj_decref(obj);
-		if (equal == false)
-			break;  /* stop compare on first mismatch */
-	}
-	return i == l1 ? true : false;  /* true (1) = equal, false (0) = not equal */
-}
-
-
-static Object *list_eql(ListObject *op1, ListObject *op2)
-{
-	int result = list_cmp(op1, op2);
-
-	return obj_create(INT_T, (int_t)result);
-}
-
-
-static Object *list_neq(ListObject *op1, ListObject *op2)
-{
-	int result = list_cmp(op1, op2);
-
-	return obj_create(INT_T, (int_t)!result);
-}
-
-
-/* Retrieve a listnode from a list by index.
- * Beware: The refcount of the listnode is increased by 1.
- */
-static ListNode *list_item(ListObject *list, int index)
-{
-	ListNode *node;
-	int_t len, i;
-
-	len = length(list);
-
-	if (index < 0)
-		index += len;
-
-	if (index < 0 || index >= len)
-		return NULL;  /* IndexError: index out of range */
-
-	for (i = 0, node = list->head; node; i++, node = node->next) {
-		if (i == index) {
-			break;
-		}
-	}
-
-	obj_incref(node);
-
-	return node;
-}
-
-
-/* Create a new list from a slice of an existing list.
- *
- * The new list contains new object (= deep copy). Start and end are
- * automatically adjusted to the nearest possible values.
- */
-static ListObject *list_slice(ListObject *list, int start, int end)
-{
-	ListObject *slice;
-	ListNode *node;
-	int_t len;
-
-	len = length(list);
-
-	if (start < 0)
-		start += len;
-
-	if (end < 0)
-		end += len;
-
-	if (start < 0)
-		start = 0;
-
-	if (end >= len)
-		end = len;
-
-	slice = (ListObject *)obj_alloc(LIST_T);
-
-	for (int_t i = start; i < end; i++) {
-		node = listtype.item(list, i);
-		listtype.append(slice, obj_copy(node->obj));
-		obj_decref(node);
-	}
-
-	return slice;
-}
-
-
-/* Append an object to the end of a list.
- *
- * list     list to append object to
- * obj      object to append
- */
-static void list_append_object(ListObject *list, Object *obj)
-{
-	ListNode *node, *tail;
-
-	node = (ListNode *)obj_create(LISTNODE_T, obj);
-
-	if (list->head == NULL) {  /* append to empty list */
-		list->head = node;
-		list->tail = node;
-	} else {  /* append to list which already has one of more listnodes */
-		tail = list->tail;
-		node->prev = tail;
-		tail->next = node;
-		list->tail = node;
-	}
-}
-
-
-/* Insert an object before the listnode with number index.
- *
- * Index is automatically adjusted to the nearest possible value.
- * A negative index counts back from the end of the list. Index -1
- * points to the last listnode.
- *
- * list     list to insert object into
- * index    insert object before this index
- * obj      object to insert
- */
-static void list_insert_object(ListObject *list, int index, Object *obj)
-{
-	ListNode *node, *iptr;
-	int_t len;
-
-	node = (ListNode *)obj_create(LISTNODE_T, obj);
-
-	if (list->head == NULL) {  /* insert in empty list */
-		list->head = node;
-		list->tail = node;
-	} else {  /* insert in list which already has one or more listnodes */
-		len = length(list);
-
-		if (index < 0)
-			index += len;
-
-		if (index <= 0) {  /* insert before first listnode */
-			node->next = list->head;
-			node->next->prev = node;
-			node->prev = NULL;
-			list->head = node;
-		} else if (index >= len) {  /* insert after last listnode */
-			iptr = list->tail;
-			node->prev = iptr;
-			iptr->next = node;
-			list->tail = node;
-		} else {  /* insert somewhere in the middle */
-			for (iptr = list->head; index--; iptr = iptr->next)
-				;
-			/* insert before iptr */
-			node->next = iptr;
-			node->prev = iptr->prev;
-			node->next->prev = node;
-			node->prev->next = node;
-		}
-	}
-}
-
-
-/* Remove a listnode from a list.
- *
- * Index must exist (numbering starts at 0). A negative index counts back
- * from the end of the list. Index -1 points to the last listnode.
- *
- * list     list to remove object from
- * index    index of object to remove
- * return   object which was removed from list
- */
-static Object *list_remove_object(ListObject *list, int index)
-{
-	ListNode *node;
-	Object *obj = NULL;
-	int_t len, i;
-
-	len = length(list);
-
-	if (index < 0)
-		index += len;  /* negative index */
-
-	if (index < 0 || index >= len)
-		return NULL;  /* IndexError: index out of range */
-
-	for (i = 0, node = list->head; node; i++, node = node->next) {
-		if (i == index) {
-			obj = node->obj;
-			if (list->head == list->tail) {  /* list contains only 1 node */
-				list->head = NULL;
-				list->tail = NULL;
-			} else if (node->prev == NULL) {  /* at least 2 nodes, remove first */
-				list->head = node->next;
-				node->next->prev = NULL;
-			} else if (node->next == NULL) {  /* at least 2 nodes, remove last */
-				list->tail = node->prev;
-				node->prev->next = NULL;
-			} else {  /* at least 3 nodes, node is not first or last */
-				node->prev->next = node->next;
-				node->next->prev = node->prev;
-			}
-			obj_incref(obj);  /* avoid that obj (= return value) is released */
-			obj_decref(node);
-			break;
-		}
-	}
-	return obj;
-}
-
-
-/* List object API.
-*/
-ListType listtype = {
-	.name = "list",
-	.alloc = (Object *(*)())list_alloc,
-	.free = (void (*)(Object *))list_free,
-	.print = (void (*)(Object *))list_print,
-	.set = (Object *(*)())list_set,
-	.vset = (Object *(*)(Object *, va_list))list_vset,
-
-	.length = list_length,
-	.item = list_item,
-	.slice = list_slice,
-	.concat = list_concat,
-	.repeat = list_repeat,
-	.eql = list_eql,
-	.neq = list_neq,
-	.insert = list_insert_object,
-	.append = list_append_object,
-	.remove = list_remove_object
-	};
-
-
-/* Listnode object API.
- */
-ListNodeType listnodetype = {
-	.name = "listnode",
-	.alloc = (Object *(*)())listnode_alloc,
-	.free = (void (*)(Object *))listnode_free,
-	.print = (void (*)(Object *))listnode_print,
-	.set = (Object *(*)())listnode_set,
-	.vset = (Object *(*)(Object *, va_list))listnode_vset
-	};
+/* list.c
+ *
+ * List object operations
+ *
+ * See list.h for an explanation of of how lists are structured.
+ *
+ * Copying a list - on assignment or when passing it to a function - does
+ * not copy its content. Instead the copy shares the array with listnodes
+ * of the original (copy-on-write). Only when one of the lists sharing an
+ * array is changed, this list gets its own array with copies of all
+ * objects.
+ *
+ * A listnode is an lvalue: a value can be assigned to it, and a for loop
+ * binds its loop variable to the listnodes of the list. This means that
+ * a listnode which is handed out by list_item() can be changed later,
+ * even if the list itself is not touched. Therefore list_item() first
+ * makes sure the list does not share its array, and marks the array as
+ * escaped. An escaped array is only shared if none of its listnodes are
+ * referenced from outside the list anymore. Reading an item via
+ * list_value() does not hand out the listnode.
+ *
+ * 2016 K.W.E. de Lange
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "object.h"
+#include "number.h"
+#include "output.h"
+#include "error.h"
+#include "pool.h"
+
+static Pool listpool = POOL("list", ListObject);
+static Pool listnodepool = POOL("listnode", ListNode);
+
+#define SIZE(list)	((list)->items ? (list)->items->size : 0)
+
+
+/* Create a new empty list object.
+ */
+static ListObject *list_alloc(void)
+{
+	ListObject *list = pool_alloc(&listpool);
+
+	list->type = LIST_T;
+	list->refcount = 0;
+
+	list->items = NULL;
+
+	return list;
+}
+
+
+/* Release an array with listnodes. When it is no longer shared the array
+ * is freed, including the listnodes and the referenced objects.
+ */
+static void release(ListItems *items)
+{
+	ListNode *node;
+
+	if (items == NULL || --items->refcount > 0)
+		return;
+
+	while (items->size > 0) {
+		node = items->node[--items->size];
+		obj_decref(node);
+	}
+	free(items);
+}
+
+
+/* Free a list object, including all list nodes and referenced objects.
+ */
+static void list_free(ListObject *list)
+{
+	release(list->items);
+	pool_free(&listpool, list);
+}
+
+
+static void list_print(ListObject *list)
+{
+	int size = SIZE(list);
+
+	output_char('[');
+
+	for (int i = 0; i < size; i++) {
+		obj_print(list->items->node[i]->obj);
+		if (i < size - 1)
+			output_char(',');
+	}
+	output_char(']');
+}
+
+
+/* Make sure a list has room for at least n listnodes. The capacity is
+ * doubled until it is large enough. The list may not share its array.
+ */
+static void reserve(ListObject *list, int n)
+{
+	ListItems *items;
+	int capacity = list->items ? list->items->capacity : 0;
+
+	if (n <= capacity)
+		return;
+
+	for (capacity = capacity ? capacity : 8; capacity < n; capacity *= 2)
+		;
+
+	if ((items = realloc(list->items, sizeof(ListItems) + capacity * sizeof(ListNode *))) == NULL)
+		error(OutOfMemoryError);
+
+	if (list->items == NULL) {
+		items->refcount = 1;
+		items->escaped = false;
+		items->size = 0;
+	}
+	items->capacity = capacity;
+
+	list->items = items;
+}
+
+
+/* Append copies of the objects in listnodes start up to end of array src
+ * to list dest.
+ */
+static void append_copies(ListObject *dest, ListItems *src, int start, int end)
+{
+	reserve(dest, SIZE(dest) + (end - start));
+
+	for (int i = start; i < end; i++)
+		listtype.append(dest, obj_copy(src->node[i]->obj));
+}
+
+
+/* Make sure a list does not share its array with other lists, so it can
+ * be changed. If needed the list gets its own copy of the array.
+ */
+static void unshare(ListObject *list)
+{
+	ListItems *items = list->items;
+
+	if (items == NULL || items->refcount == 1)
+		return;
+
+	list->items = NULL;
+
+	append_copies(list, items, 0, items->size);
+
+	items->refcount--;  /* still shared by others, so never freed here */
+}
+
+
+/* Check if listnodes in an escaped array are still referenced from outside
+ * the list. If not the array is no longer considered escaped.
+ */
+static bool escaped(ListItems *items)
+{
+	if (items->escaped) {
+		for (int i = 0; i < items->size; i++)
+			if (items->node[i]->refcount > 1)
+				return true;
+		items->escaped = false;
+	}
+	return false;
+}
+
+
+/* Make list dest a copy of list src.
+ *
+ * The array of src is shared, unless some of its listnodes are referenced
+ * from outside the list. Then the objects are copied (= deep copy).
+ */
+static ListObject *list_set(ListObject *dest, ListObject *src)
+{
+	ListItems *items = dest->items;
+
+	if (dest == src)
+		return dest;
+
+	dest->items = NULL;
+
+	if (src->items) {
+		if (escaped(src->items))
+			append_copies(dest, src->items, 0, src->items->size);
+		else {
+			dest->items = src->items;
+			dest->items->refcount++;
+		}
+	}
+
+	release(items);  /* only now, as src may be part of dest */
+
+	return dest;
+}
+
+
+static ListObject *list_vset(ListObject *obj, va_list argp)
+{
+	return list_set(obj, va_arg(argp, ListObject *));
+}
+
+
+/* Create a new empty listnode.
+ */
+static ListNode *listnode_alloc(void)
+{
+	ListNode *node = pool_alloc(&listnodepool);
+
+	node->type = LISTNODE_T;
+	node->refcount = 0;
+
+	node->obj = NULL;
+
+	return node;
+}
+
+
+/* Free a listnode, and release the object it references.
+ */
+static void listnode_free(ListNode *node)
+{
+	if (node->obj)
+		obj_decref(node->obj);
+
+	pool_free(&listnodepool, node);
+}
+
+
+static void listnode_print(ListNode *node)
+{
+	obj_print(node->obj);
+}
+
+
+static ListNode *listnode_set(ListNode *node, Object *obj)
+{
+	if (node->obj)
+		obj_decref(node->obj);
+
+	node->obj = obj;
+
+	return node;
+}
+
+
+static ListNode *listnode_vset(ListNode *node, va_list argp)
+{
+	return listnode_set(node, va_arg(argp, Object *));
+}
+
+
+static Object *list_length(ListObject *list)
+{
+	return inttype.value((int_t)SIZE(list));
+}
+
+
+/* Create a new list which contains the objects from op1 and op2.
+ */
+static Object *list_concat(ListObject *op1, ListObject *op2)
+{
+	ListObject *list;
+	int len1 = SIZE(op1), len2 = SIZE(op2);  /* op1 and op2 may be the same list */
+
+	list = (ListObject *)obj_alloc(LIST_T);
+
+	if (len1 > 0)
+		append_copies(list, op1->items, 0, len1);
+	if (len2 > 0)
+		append_copies(list, op2->items, 0, len2);
+
+	return (Object *)list;
+}
+
+
+/* Create a new list which contains n times an existing list.
+ */
+static Object *list_repeat(Object *op1, Object *op2)
+{
+	ListObject *list;
+	int_t times;
+
+	ListObject *s = (ListObject *)(TYPE(op1) == LIST_T ? op1 : op2);
+	Object *n = TYPE(op1) == LIST_T ? op2 : op1;
+
+	times = obj_as_int(n);
+
+	list = (ListObject *)obj_alloc(LIST_T);
+
+	if (SIZE(s) == 0)
+		return (Object *)list;
+
+	if (times > 0)
+		reserve(list, SIZE(s) * times);
+
+	while (times-- > 0)
+		append_copies(list, s->items, 0, s->items->size);
+
+	return (Object *)list;
+}
+
+
+/* Compare the content of two lists by index (math: tuple).
+ */
+static bool list_cmp(ListObject *op1, ListObject *op2)
+{
+	bool equal = true;
+	Object *obj;
+
+	if (SIZE(op1) != SIZE(op2))
+		return false;  /* the lists should at least be of equal length */
+
+	if (op1->items == op2->items)
+		return true;  /* shared array (or both empty) */
+
+	for (int i = 0; i < SIZE(op1) && equal; i++) {
+		obj = obj_eql((Object *)op1->items->node[i], (Object *)op2->items->node[i]);
+		equal = obj_as_bool(obj);  /* stop compare on first mismatch */
+		obj_decref(obj);
+	}
+	return equal;  /* true (1) = equal, false (0) = not equal */
+}
+
+
+static Object *list_eql(ListObject *op1, ListObject *op2)
+{
+	int result = list_cmp(op1, op2);
+
+	return inttype.value((int_t)result);
+}
+
+
+static Object *list_neq(ListObject *op1, ListObject *op2)
+{
+	int result = list_cmp(op1, op2);
+
+	return inttype.value((int_t)!result);
+}
+
+
+/* Retrieve a listnode from a list by index. The listnode can be used as
+ * an lvalue, so the list gets its own array first.
+ * Beware: The refcount of the listnode is increased by 1.
+ */
+static ListNode *list_item(ListObject *list, int index)
+{
+	if (index < 0)
+		index += SIZE(list);
+
+	if (index < 0 || index >= SIZE(list))
+		return NULL;  /* IndexError: index out of range */
+
+	unshare(list);
+
+	list->items->escaped = true;
+
+	obj_incref(list->items->node[index]);
+
+	return list->items->node[index];
+}
+
+
+/* Retrieve the object stored in a list by index, for reading only.
+ * Beware: The refcount of the object is increased by 1.
+ */
+static Object *list_value(ListObject *list, int index)
+{
+	Object *obj;
+
+	if (index < 0)
+		index += SIZE(list);
+
+	if (index < 0 || index >= SIZE(list))
+		return NULL;  /* IndexError: index out of range */
+
+	obj = list->items->node[index]->obj;
+
+	obj_incref(obj);
+
+	return obj;
+}
+
+
+/* Create a new list from a slice of an existing list.
+ *
+ * The new list contains new object (= deep copy). Start and end are
+ * automatically adjusted to the nearest possible values.
+ */
+static ListObject *list_slice(ListObject *list, int start, int end)
+{
+	ListObject *slice;
+	int len = SIZE(list);
+
+	if (start < 0)
+		start += len;
+
+	if (end < 0)
+		end += len;
+
+	if (start < 0)
+		start = 0;
+
+	if (end >= len)
+		end = len;
+
+	slice = (ListObject *)obj_alloc(LIST_T);
+
+	if (start < end)
+		append_copies(slice, list->items, start, end);
+
+	return slice;
+}
+
+
+/* Append an object to the end of a list.
+ *
+ * list     list to append object to
+ * obj      object to append
+ */
+static void list_append_object(ListObject *list, Object *obj)
+{
+	unshare(list);
+
+	reserve(list, SIZE(list) + 1);
+
+	list->items->node[list->items->size++] = (ListNode *)obj_create(LISTNODE_T, obj);
+}
+
+
+/* Insert an object before the listnode with number index.
+ *
+ * Index is automatically adjusted to the nearest possible value.
+ * A negative index counts back from the end of the list. Index -1
+ * points to the last listnode.
+ *
+ * list     list to insert object into
+ * index    insert object before this index
+ * obj      object to insert
+ */
+static void list_insert_object(ListObject *list, int index, Object *obj)
+{
+	ListItems *items;
+
+	if (index < 0)
+		index += SIZE(list);
+
+	if (index < 0)
+		index = 0;  /* insert before first listnode */
+	else if (index > SIZE(list))
+		index = SIZE(list);  /* insert after last listnode */
+
+	unshare(list);
+
+	reserve(list, SIZE(list) + 1);
+
+	items = list->items;
+
+	memmove(&items->node[index + 1], &items->node[index], (items->size - index) * sizeof(ListNode *));
+
+	items->node[index] = (ListNode *)obj_create(LISTNODE_T, obj);
+	items->size++;
+}
+
+
+/* Remove a listnode from a list.
+ *
+ * Index must exist (numbering starts at 0). A negative index counts back
+ * from the end of the list. Index -1 points to the last listnode.
+ *
+ * list     list to remove object from
+ * index    index of object to remove
+ * return   object which was removed from list
+ */
+static Object *list_remove_object(ListObject *list, int index)
+{
+	ListItems *items;
+	ListNode *node;
+	Object *obj;
+
+	if (index < 0)
+		index += SIZE(list);  /* negative index */
+
+	if (index < 0 || index >= SIZE(list))
+		return NULL;  /* IndexError: index out of range */
+
+	unshare(list);
+
+	items = list->items;
+
+	node = items->node[index];
+	obj = node->obj;
+
+	memmove(&items->node[index], &items->node[index + 1], (items->size - index - 1) * sizeof(ListNode *));
+	items->size--;
+
+	obj_incref(obj);  /* avoid that obj (= return value) is released */
+	obj_decref(node);
+
+	return obj;
+}
+
+
+/* List object API.
+*/
+ListType listtype = {
+	.name = "list",
+	.alloc = (Object *(*)())list_alloc,
+	.free = (void (*)(Object *))list_free,
+	.print = (void (*)(Object *))list_print,
+	.set = (Object *(*)())list_set,
+	.vset = (Object *(*)(Object *, va_list))list_vset,
+
+	.length = list_length,
+	.item = list_item,
+	.value = list_value,
+	.slice = list_slice,
+	.concat = list_concat,
+	.repeat = list_repeat,
+	.eql = list_eql,
+	.neq = list_neq,
+	.insert = list_insert_object,
+	.append = list_append_object,
+	.remove = list_remove_object
+	};
+
+
+/* Listnode object API.
+ */
+ListNodeType listnodetype = {
+	.name = "listnode",
+	.alloc = (Object *(*)())listnode_alloc,
+	.free = (void (*)(Object *))listnode_free,
+	.print = (void (*)(Object *))listnode_print,
+	.set = (Object *(*)())listnode_set,
+	.vset = (Object *(*)(Object *, va_list))listnode_vset
+	};
@@ -1,125 +1,384 @@
-/* module.c
- *
- * Code is stored in modules. Each module is a file. Modules are loaded via
- * the (global) module.new() function. Every module object contains a
- * reference to the loaded code of that module. Module objects are
- * stored in a singly linked list starting at 'modulehead'.
- *
- * 1995	K.W.E. de Lange
- */
-#include <sys/stat.h>
-#include <assert.h>
-#include <stdlib.h>
-#include <string.h>
-#include <errno.h>
-#include <stdio.h>
-#include "module.h"
-#include "strdup.h"
-#include "error.h"
-
-
-/* Pointer to the list of loaded modules.
- */
-static Module *modulehead = NULL;
-
-
-/* API: Search a module in the list of loaded modules.
- *
- * name		filename of module (may include path)
- * return	module object or NULL if not found
- */
-static Module *search(const char *name)
-{
-	Module *m;
-
-	assert(name != NULL);
-	assert(*name != '\0');
-
-	for (m = modulehead; m; m = m->next)
-		if (strcmp(name, m->name) == 0)
-			break;
-
-	return m;
-}
-
-
-/* Load the code for a module. Two closing newlines and '\0' are added
- * at the end of the code.
- *
- * self		pointer to module object
- * name		filename (may include path)
- * return	1 if successful else 0
- */
-static int load(Module *self, const char *name)
-{
-	FILE *fp;
-	struct _stat stat_buffer;
-
-	assert(self != NULL);
-	assert(name != NULL);
-	assert(*name != '\0');
-
-	if (_stat(name, &stat_buffer) == 0) {
-		self->size = stat_buffer.st_size;
-		if ((self->code = calloc(self->size + 3, sizeof(char))) != NULL) {
-			if ((fp = fopen(name, "r")) != NULL) {
-				self->size = fread(self->code, sizeof(char), self->size, fp);
-				fclose(fp);
-				self->code[self->size] = '\n';
-				self->code[self->size + 1] = '\n';
-				self->code[self->size + 2] = 0;
-				return 1;
-			} else {
-				free(self->code);
-				self->code = NULL;
-			}
-		}
-	}
-	return 0;
-}
-
-
-/* API: Create a new module object and load the code.
- *
- * name		module's filename (may include path)
- * return	module object (else an error is raised and the the program exits)
- */
-static Module *new(const char *name)
-{
-	Module *m;
-
-	assert(name != NULL);
-	assert(*name != '\0');
-
-	if ((m = calloc(1, sizeof(Module))) == NULL)
-		error(OutOfMemoryError);
-	else
-		*m = module;
-
-	if (load(m, name) == 0)
-		error(SystemError, "error importing %s: %s (%d)", name, \
-							strerror(errno), errno);
-
-	if ((m->name = strdup(name)) == NULL)
-		error(OutOfMemoryError);
-
-	m->next = modulehead;
-	modulehead = m;
-
-	assert(m != NULL);
-
-	return m;
-}
-
-
-/*	The module API.
- */
-Module module = {
-	.next = NULL,
-	.name = "",
-	.code = "\n",
-	.size = 0,
-
-	.new = new,
-	.search = search
-	};
+/* module.c
+ *
+ * Code is stored in modules. Each module is a file. Modules are loaded via
+ * the (global) module.new() function. Every module object contains a
+ * reference to the loaded code of that module, and to the bytecode it was
+ * compiled into or which was loaded from the cache.
+ *
+ * A module name is resolved to the canonical path of its file, so the
+ * same file is only loaded once no matter how it is named in an import
+ * statement. Loaded modules are kept in a hash table keyed by this path.
+ * A name which is not found relative to the working directory is searched
+ * in the directories of the module search path (environment variable
+ * EXINPATH, directories separated by ':', or ';' on Windows).
+ *
+ * On systems which support it the code of a module is mapped into memory
+ * instead of read into a buffer. Define NO_MMAP to always read it.
+ *
+ * 1995	K.W.E. de Lange
+ */
+#if defined(__unix__) || defined(__APPLE__)
+	#define _DEFAULT_SOURCE  /* mmap() and realpath() are not part of C99 */
+	#ifndef NO_MMAP
+		#define MMAP
+	#endif
+#endif
+
+#include <sys/stat.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include "scanner.h"
+#include "module.h"
+#include "intern.h"
+#include "error.h"
+
+#ifdef MMAP
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+#ifdef _WIN32
+	#define PATHSEP	';'		/* separates the directories in EXINPATH */
+#else
+	#define PATHSEP	':'
+#endif
+
+
+static Module **table = NULL;	/* hash table with loaded modules, NULL = empty entry */
+static size_t tablesize = 0;	/* number of entries, always a power of 2 */
+static size_t count = 0;		/* number of modules in the table */
+
+
+/* Return the canonical path of a file.
+ *
+ * return	interned path, or NULL if the file does not exist
+ */
+static char *canonical(const char *name)
+{
+	char *full, *path = NULL;
+
+	#if defined(_WIN32)
+	struct _stat stat_buffer;
+
+	if (_stat(name, &stat_buffer) == 0 && (full = _fullpath(NULL, name, 0)) != NULL) {
+		path = intern(full);
+		free(full);
+	}
+	#elif defined(__unix__) || defined(__APPLE__)
+	if ((full = realpath(name, NULL)) != NULL) {
+		path = intern(full);
+		free(full);
+	}
+	#else  /* no way to canonicalize, use the name as it is */
+	struct _stat stat_buffer;
+
+	(void)full;
+	if (_stat(name, &stat_buffer) == 0)
+		path = intern(name);
+	#endif
+
+	return path;
+}
+
+
+/* Find the file of a module. The name is first tried as it is, so relative
+ * to the working directory. If the file is not found there, and the name
+ * is not an absolute path, every directory in the search path is tried.
+ *
+ * name		filename of module (may include path)
+ * return	interned canonical path of the file, or NULL if not found
+ */
+static char *resolve(const char *name)
+{
+	const char *dir, *end;
+	char *path, *buffer;
+	size_t len;
+
+	if ((path = canonical(name)) != NULL || config.path == NULL)
+		return path;
+
+	if (*name == '/' || *name == '\\' || (*name && name[1] == ':'))
+		return NULL;  /* absolute path */
+
+	if ((buffer = malloc(strlen(config.path) + strlen(name) + 2)) == NULL)
+		error(OutOfMemoryError);
+
+	for (dir = config.path; path == NULL && *dir; dir = *end ? end + 1 : end) {
+		if ((end = strchr(dir, PATHSEP)) == NULL)
+			end = dir + strlen(dir);
+		if ((len = end - dir) == 0)
+			continue;
+		memcpy(buffer, dir, len);
+		buffer[len] = '/';
+		strcpy(buffer + len + 1, name);
+		path = canonical(buffer);
+	}
+
+	free(buffer);
+
+	return path;
+}
+
+
+/* Find the entry in the hash table for a module file.
+ *
+ * return	index of the entry which contains the module, or if the module
+ *			is not loaded yet, of the empty entry to use for it
+ */
+static size_t probe(const char *path)
+{
+	size_t i, mask = tablesize - 1;
+
+	for (i = intern_hash(path) & mask; table[i] != NULL; i = (i + 1) & mask)
+		if (table[i]->path == path)  /* interned, so compare pointers */
+			break;
+
+	return i;
+}
+
+
+/* Double the size of the hash table and reinsert all modules.
+ */
+static void grow(void)
+{
+	Module **old = table;
+	size_t oldsize = tablesize;
+
+	tablesize = tablesize ? tablesize * 2 : 16;
+
+	if ((table = calloc(tablesize, sizeof(Module *))) == NULL)
+		error(OutOfMemoryError);
+
+	for (size_t i = 0; i < oldsize; i++)
+		if (old[i] != NULL)
+			table[probe(old[i]->path)] = old[i];
+
+	free(old);
+}
+
+
+/* API: Search a module in the table of loaded modules.
+ *
+ * name		filename of module (may include path)
+ * return	module object or NULL if not found
+ */
+static Module *search(const char *name)
+{
+	char *path;
+
+	assert(name != NULL);
+	assert(*name != '\0');
+
+	if (tablesize == 0 || (path = resolve(name)) == NULL)
+		return NULL;
+
+	return table[probe(path)];
+}
+
+
+#ifdef MMAP
+
+/* Map the code of a module into memory. The reader and scanner work
+ * directly on the mapped pages, nothing is copied. The code must be
+ * followed by a '\0' without writing into the mapping. If the size of the
+ * file is not a multiple of the page size the remainder of the last page
+ * is filled with zeroes by the system. If it is, an anonymous zero page
+ * is reserved behind the code and the file is mapped in front of it.
+ *
+ * self		pointer to module object
+ * fd		file descriptor of module file
+ * return	1 if successful else 0
+ */
+static int map(Module *self, int fd)
+{
+	size_t pagesize = (size_t)sysconf(_SC_PAGESIZE);
+	char *p;
+
+	if (self->size % pagesize != 0) {
+		if ((p = mmap(NULL, self->size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+			return 0;
+	} else {
+		if ((p = mmap(NULL, self->size + pagesize, PROT_READ, \
+					  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+			return 0;
+		if (self->size > 0 && mmap(p, self->size, PROT_READ, \
+								   MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+			munmap(p, self->size + pagesize);
+			return 0;
+		}
+	}
+
+	self->code = p;
+
+	return 1;
+}
+
+
+/* Load the code for a module by mapping the file into memory.
+ *
+ * self		pointer to module object
+ * name		filename (may include path)
+ * return	1 if successful else 0
+ */
+static int load(Module *self, const char *name)
+{
+	struct stat stat_buffer;
+	int fd, result = 0;
+
+	assert(self != NULL);
+	assert(name != NULL);
+	assert(*name != '\0');
+
+	if ((fd = open(name, O_RDONLY)) != -1) {
+		if (fstat(fd, &stat_buffer) == 0) {
+			self->size = stat_buffer.st_size;
+			result = map(self, fd);
+		}
+		close(fd);
+	}
+	return result;
+}
+
+#else  /* not MMAP */
+
+/* Load the code for a module. A '\0' is added at the end of the code.
+ *
+ * self		pointer to module object
+ * name		filename (may include path)
+ * return	1 if successful else 0
+ */
+static int load(Module *self, const char *name)
+{
+	FILE *fp;
+	struct _stat stat_buffer;
+
+	assert(self != NULL);
+	assert(name != NULL);
+	assert(*name != '\0');
+
+	if (_stat(name, &stat_buffer) == 0) {
+		self->size = stat_buffer.st_size;
+		if ((self->code = calloc(self->size + 1, sizeof(char))) != NULL) {
+			if ((fp = fopen(name, "r")) != NULL) {
+				self->size = fread(self->code, sizeof(char), self->size, fp);
+				fclose(fp);
+				self->code[self->size] = 0;
+				return 1;
+			} else {
+				free(self->code);
+				self->code = NULL;
+			}
+		}
+	}
+	return 0;
+}
+
+#endif  /* MMAP */
+
+
+/* API: Create a new module object and load the code.
+ *
+ * name		module's filename (may include path)
+ * return	module object (else an error is raised and the the program exits)
+ */
+static Module *new(const char *name)
+{
+	Module *m;
+
+	assert(name != NULL);
+	assert(*name != '\0');
+
+	if ((m = calloc(1, sizeof(Module))) == NULL)
+		error(OutOfMemoryError);
+	else
+		*m = module;
+
+	if ((m->path = resolve(name)) == NULL || load(m, m->path) == 0)
+		error(SystemError, "error importing %s: %s (%d)", name, \
+							strerror(errno), errno);
+
+	m->name = intern(name);
+
+	if (2 * (count + 1) > tablesize)  /* keep load factor <= 0.5 */
+		grow();
+
+	table[probe(m->path)] = m;
+	count++;
+
+	assert(m != NULL);
+
+	return m;
+}
+
+
+/* Build the index with the offsets where the lines of module self start.
+ */
+static void index_lines(Module *self)
+{
+	char *p, *end = self->code + self->size;
+	int n = 1;
+
+	for (p = self->code; (p = memchr(p, '\n', end - p)) != NULL; p++)
+		n++;
+
+	if ((self->lines = malloc(n * sizeof(unsigned int))) == NULL)
+		error(OutOfMemoryError);
+
+	self->lines[0] = 0;
+	self->nlines = 1;
+
+	for (p = self->code; (p = memchr(p, '\n', end - p)) != NULL; p++)
+		self->lines[self->nlines++] = (unsigned int)(p + 1 - self->code);
+}
+
+
+/* API: Return the number of the line which contains offset. Lines are
+ * numbered from 1. The first call builds the line index, after that the
+ * line is found via a binary search.
+ *
+ * offset	offset in the code of module self
+ * return	line number
+ */
+static int line(Module *self, size_t offset)
+{
+	int lo = 0, hi, mid;
+
+	if (self->lines == NULL)
+		index_lines(self);
+
+	hi = self->nlines - 1;
+
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (self->lines[mid] <= offset)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return lo + 1;
+}
+
+
+/*	The module API.
+ */
+Module module = {
+	.name = "",
+	.path = "",
+	.code = "\n",
+	.size = 0,
+	.tokens = NULL,
+	.ntokens = 0,
+	.tree = NULL,
+	.bytecode = NULL,
+	.lines = NULL,
+	.nlines = 0,
+
+	.new = new,
+	.search = search,
+	.line = line
+	};
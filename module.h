@@ -1,28 +1,38 @@
-/* module.h
- *
- * 2018	K.W.E. de Lange
- */
-#ifndef _MODULE_
-#define _MODULE_
-
-#include <stddef.h>
-
-/* This struct is the API to a module object, containing both data and
- * function adresses.
- *
- * Function new() loads a new module. Function search() looks for a module
- * in the list of loaded modules.
- */
-typedef struct module {
-	struct module *next;	/* next module in list with loaded modules */
-	char *name;				/* module name */
-	char *code;  			/* buffer containing module code */
-	size_t size;			/* number of bytes in code buffer */
-
-	struct module *(*new)(const char *name);	/* load new module */
-	struct module *(*search)(const char *name);	/* search for loaded module */
-} Module;
-
-extern Module module;
-
-#endif
+/* module.h
+ *
+ * 2018	K.W.E. de Lange
+ */
+#ifndef _MODULE_
+#define _MODULE_
+
+#include <stddef.h>
+
+/* This struct is the API to a module object, containing both data and
+ * function adresses.
+ *
+ * Function new() loads a new module. The code is converted into tokens by
+ * the scanner, unless its bytecode is loaded from the cache (see cache.c).
+ * Function search() looks for a module in the table of loaded modules.
+ * Function line() returns the number of the line containing an offset in
+ * the code. The offsets where the lines start are indexed on first use.
+ */
+typedef struct module {
+	char *name;				/* module name as used in the import */
+	char *path;				/* canonical path of the module file */
+	char *code;  			/* module code followed by '\0', read-only */
+	size_t size;			/* number of bytes of code */
+	struct token *tokens;	/* code converted to tokens (see scanner.h), freed after parsing */
+	size_t ntokens;			/* number of tokens, last one is ENDMARKER */
+	struct node *tree;		/* tokens converted to syntax tree (see ast.h), freed after compiling */
+	struct code *bytecode;	/* syntax tree compiled to bytecode (see code.h) */
+	unsigned int *lines;	/* offset of the start of each line, NULL if not indexed */
+	int nlines;				/* number of lines */
+
+	struct module *(*new)(const char *name);	/* load new module */
+	struct module *(*search)(const char *name);	/* search for loaded module */
+	int (*line)(struct module *self, size_t offset);	/* line number of offset */
+} Module;
+
+extern Module module;
+
+#endif
@@ -0,0 +1,156 @@
+/* output.c
+ *
+ * Output of the print statement.
+ *
+ * Everything a program prints is collected in a large buffer which is
+ * written to stdout in one go, instead of passing every value and
+ * separator to stdio and flushing after each of them. When stdout is a
+ * terminal the buffer is flushed at the end of every line, so output
+ * appears as soon as a line is complete. Otherwise the buffer is only
+ * flushed when it is full, before input is read, when an error is
+ * reported and when the program ends. With debug output switched on
+ * every write is flushed, so it stays in order with the debug messages.
+ *
+ * Integers are converted to text directly into the buffer; floats use
+ * snprintf() as their format (%.15G) is not trivial to reproduce.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#if defined(__unix__) || defined(__APPLE__)
+	#define _DEFAULT_SOURCE  /* isatty() and fileno() are not part of C99 */
+	#include <unistd.h>
+	#define ISATTY(fp)	isatty(fileno(fp))
+#elif defined(_WIN32)
+	#include <io.h>
+	#define ISATTY(fp)	_isatty(_fileno(fp))
+#else
+	#define ISATTY(fp)	1  /* unknown, assume a terminal */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "output.h"
+#include "config.h"
+
+#define OUTSIZE		65536		/* number of bytes in the output buffer */
+
+static enum {
+	UNKNOWN,					/* output mode not yet determined */
+	UNBUFFERED,					/* flush after every write */
+	LINEBUFFERED,				/* flush at the end of every line */
+	BUFFERED					/* flush when the buffer is full */
+} mode = UNKNOWN;
+
+static char buffer[OUTSIZE];
+static size_t length = 0;		/* number of bytes in the buffer */
+
+
+/* API: Write the contents of the buffer to stdout.
+ */
+void output_flush(void)
+{
+	if (length) {
+		fwrite(buffer, sizeof(char), length, stdout);
+		length = 0;
+	}
+	fflush(stdout);
+}
+
+
+/* Determine the output mode at the first write.
+ */
+static void setup(void)
+{
+	if (config.debug)
+		mode = UNBUFFERED;
+	else if (ISATTY(stdout))
+		mode = LINEBUFFERED;
+	else
+		mode = BUFFERED;
+
+	atexit(output_flush);
+}
+
+
+/* Flush the buffer if the output mode requires it.
+ *
+ * newline	true if a line end was written
+ */
+static inline void written(int newline)
+{
+	if (mode == UNBUFFERED || (newline && mode == LINEBUFFERED))
+		output_flush();
+}
+
+
+/* API: Write len characters from s.
+ */
+void output_write(const char *s, size_t len)
+{
+	if (mode == UNKNOWN)
+		setup();
+
+	if (length + len > OUTSIZE) {
+		output_flush();
+		if (len > OUTSIZE) {  /* does not fit, bypass the buffer */
+			fwrite(s, sizeof(char), len, stdout);
+			written(1);
+			return;
+		}
+	}
+
+	memcpy(buffer + length, s, len);
+	length += len;
+
+	written(memchr(s, '\n', len) != NULL);
+}
+
+
+/* API: Write a single character.
+ */
+void output_char(char c)
+{
+	if (mode == UNKNOWN)
+		setup();
+
+	if (length == OUTSIZE)
+		output_flush();
+
+	buffer[length++] = c;
+
+	written(c == '\n');
+}
+
+
+/* API: Write an integer in decimal notation.
+ */
+void output_int(long i)
+{
+	char digits[3 * sizeof(long) + 2];
+	char *p = digits + sizeof(digits);
+	unsigned long u = i < 0 ? 0UL - (unsigned long)i : (unsigned long)i;
+
+	do {
+		*--p = (char)('0' + u % 10);
+	} while (u /= 10);
+
+	if (i < 0)
+		*--p = '-';
+
+	output_write(p, digits + sizeof(digits) - p);
+}
+
+
+/* API: Write a float with 15 significant digits.
+ */
+void output_float(double f)
+{
+	char digits[32];
+	int n;
+
+	n = snprintf(digits, sizeof(digits), "%.*G", 15, f);
+
+	output_write(digits, n);
+}
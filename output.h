@@ -0,0 +1,16 @@
+/* output.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _OUTPUT_
+#define _OUTPUT_
+
+#include <stddef.h>
+
+extern void output_write(const char *s, size_t len);
+extern void output_char(char c);
+extern void output_int(long i);
+extern void output_float(double f);
+extern void output_flush(void);
+
+#endif
@@ -0,0 +1,186 @@
+/* pool.c
+ *
+ * Memory allocation for objects.
+ *
+ * Objects are small and are created and removed all the time, especially
+ * the temporary results of expressions. Instead of calling calloc() and
+ * free() for every object, every object type has its own pool. A pool
+ * takes memory from the system in large blocks (slabs) which are cut into
+ * objects of equal size. Freed objects are put in a list and are handed
+ * out again by the next pool_alloc(). Slabs are never returned to the
+ * system, but the objects in it are reused.
+ *
+ * Define NO_POOL in the compiler options to use calloc() and free() for
+ * every object instead, e.g. when searching for memory errors with a
+ * memory debugger.
+ *
+ * Every pool counts the objects it hands out and gets back. These counters
+ * are always maintained, also in release builds. With option -s or
+ * environment variable EXINSTATS they are written per object type to
+ * stderr or to a file after the program ends (see pool_stats()), so the
+ * memory use of a program and objects which are never freed (a reference
+ * count which is not decremented) can be tracked without a debug build.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "error.h"
+#include "pool.h"
+
+#define SLABSIZE	16384		/* number of bytes in a slab */
+
+static Pool *pools = NULL;		/* list with all pools which were used */
+
+
+/* Round the object size up so objects in a slab are properly aligned.
+ */
+static size_t objectsize(Pool *pool)
+{
+	return (pool->size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+}
+
+
+#ifndef NO_POOL
+/* Allocate a new slab and put all objects in it in the free list.
+ */
+static void grow(Pool *pool)
+{
+	size_t size = objectsize(pool);
+	size_t n = SLABSIZE / size;
+	char *slab;
+
+	if ((slab = malloc(n * size)) == NULL)
+		error(OutOfMemoryError);
+
+	while (n--) {
+		*(void **)(slab + n * size) = pool->free;
+		pool->free = slab + n * size;
+	}
+
+	pool->slabs++;
+}
+#endif  /* NO_POOL */
+
+
+/* Get memory for an object from a pool.
+ *
+ * return   pointer to object, all bytes are set to 0
+ */
+void *pool_alloc(Pool *pool)
+{
+	void *obj;
+
+	if (pool->allocs == 0) {  /* first use of this pool */
+		pool->next = pools;
+		pools = pool;
+	}
+
+	#ifdef NO_POOL
+	if ((obj = calloc(1, pool->size)) == NULL)
+		error(OutOfMemoryError);
+	#else
+	if (pool->free == NULL)
+		grow(pool);
+
+	obj = pool->free;
+	pool->free = *(void **)obj;
+
+	memset(obj, 0, pool->size);
+	#endif  /* NO_POOL */
+
+	pool->allocs++;
+	if (++pool->inuse > pool->peak)
+		pool->peak = pool->inuse;
+
+	return obj;
+}
+
+
+/* Return the memory of an object to its pool.
+ */
+void pool_free(Pool *pool, void *obj)
+{
+	#ifdef NO_POOL
+	free(obj);
+	#else
+	*(void **)obj = pool->free;
+	pool->free = obj;
+	#endif  /* NO_POOL */
+
+	pool->frees++;
+	pool->inuse--;
+}
+
+
+/* Print the counters of all pools which were used.
+ */
+void pool_dump(void)
+{
+	fprintf(stdout, "\n%-10s %10s %10s %10s %10s %6s\n", "pool", "allocs", "frees", "inuse", "peak", "slabs");
+
+	for (Pool *pool = pools; pool; pool = pool->next)
+		fprintf(stdout, "%-10s %10lu %10lu %10lu %10lu %6lu\n", pool->name, \
+						pool->allocs, pool->frees, pool->inuse, pool->peak, pool->slabs);
+}
+
+
+/* Write the counters of all pools which were used to the file named in
+ * config.stats, or to stderr if this is an empty string. The format is
+ * CSV if the filename ends in .csv, otherwise JSON. Per pool (so per
+ * object type) are reported: the bytes per object, the number of objects
+ * allocated and freed, the number of objects still in use (live) and
+ * its maximum (peak), and the bytes occupied by these live and peak
+ * objects. Memory referenced by objects, like the text of a string, is
+ * not included.
+ */
+void pool_stats(void)
+{
+	unsigned long allocs = 0, frees = 0, live = 0, bytes = 0;
+	size_t len = strlen(config.stats);
+	FILE *fp = stderr;
+	int csv;
+	Pool *pool;
+
+	csv = len > 4 && strcmp(config.stats + len - 4, ".csv") == 0;
+
+	if (len && (fp = fopen(config.stats, "w")) == NULL) {
+		fprintf(stderr, "cannot write statistics to %s\n", config.stats);
+		return;
+	}
+
+	if (csv)
+		fprintf(fp, "type,size,allocs,frees,live,peak,bytes,peakbytes\n");
+	else
+		fprintf(fp, "{\n\t\"types\": [");
+
+	for (pool = pools; pool; pool = pool->next) {
+		size_t size = objectsize(pool);
+
+		if (csv)
+			fprintf(fp, "%s,%zu,%lu,%lu,%lu,%lu,%lu,%lu\n", pool->name, size, \
+						pool->allocs, pool->frees, pool->inuse, pool->peak, \
+						pool->inuse * size, pool->peak * size);
+		else
+			fprintf(fp, "%s\n\t\t{\"type\": \"%s\", \"size\": %zu, \"allocs\": %lu, " \
+						"\"frees\": %lu, \"live\": %lu, \"peak\": %lu, " \
+						"\"bytes\": %lu, \"peakbytes\": %lu}", pool == pools ? "" : ",", \
+						pool->name, size, pool->allocs, pool->frees, pool->inuse, \
+						pool->peak, pool->inuse * size, pool->peak * size);
+
+		allocs += pool->allocs;
+		frees += pool->frees;
+		live += pool->inuse;
+		bytes += pool->inuse * size;
+	}
+
+	if (!csv)
+		fprintf(fp, "\n\t],\n\t\"total\": {\"allocs\": %lu, \"frees\": %lu, " \
+					"\"live\": %lu, \"bytes\": %lu}\n}\n", allocs, frees, live, bytes);
+
+	if (fp != stderr)
+		fclose(fp);
+}
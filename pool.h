@@ -0,0 +1,33 @@
+/* pool.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _POOL_
+#define _POOL_
+
+#include <stddef.h>
+
+/* A pool hands out memory for objects of a single size. Free objects are
+ * kept in a list and reused. The counters are maintained for every pool and
+ * can be shown via the debug option DEBUGPOOL or written by pool_stats().
+ */
+typedef struct pool {
+	char *name;					/* name of the objects in the pool */
+	size_t size;				/* bytes per object */
+	void *free;					/* list with free objects */
+	struct pool *next;			/* next pool in the list with all pools */
+	unsigned long allocs;		/* number of objects handed out */
+	unsigned long frees;		/* number of objects returned */
+	unsigned long inuse;		/* number of objects currently in use */
+	unsigned long peak;			/* maximum number of objects in use */
+	unsigned long slabs;		/* number of slabs allocated */
+} Pool;
+
+#define POOL(name, type)	{ name, sizeof(type), NULL, NULL, 0, 0, 0, 0, 0 }
+
+extern void *pool_alloc(Pool *pool);
+extern void pool_free(Pool *pool, void *obj);
+extern void pool_dump(void);
+extern void pool_stats(void);
+
+#endif
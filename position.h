@@ -1,24 +1,22 @@
-/* position.h
- *
- * 2018	K.W.E. de Lange
- */
-#ifndef _POSITION_
-#define _POSITION_
-
-#include "object.h"
-#include "reader.h"
-#include "scanner.h"
-
-typedef struct positionobject {
-	OBJ_HEAD;
-	struct reader reader;		/* stores relevant parts of reader */
-	struct scanner scanner;		/* stores relevant parts of scanner */
-} PositionObject;
-
-typedef struct {
-	TYPE_HEAD;
-} PositionType;
-
-extern PositionType positiontype;
-
-#endif
+/* position.h
+ *
+ * 2018	K.W.E. de Lange
+ */
+#ifndef _POSITION_
+#define _POSITION_
+
+#include "object.h"
+#include "code.h"
+
+typedef struct positionobject {
+	OBJ_HEAD;
+	struct code *code;			/* bytecode of the function */
+} PositionObject;
+
+typedef struct {
+	TYPE_HEAD;
+} PositionType;
+
+extern PositionType positiontype;
+
+#endif
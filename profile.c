@@ -0,0 +1,466 @@
+/* profile.c
+ *
+ * Profiler.
+ *
+ * When the interpreter is started with option -p the virtual machine
+ * reports every call and return of a code object (a function or a module).
+ * Next to this a timer interrupts the program every millisecond of CPU
+ * time, and takes a sample of the instruction which is being executed.
+ * At the end of the program a report is printed on stderr with per
+ * function the number of calls, and the time spent in the function
+ * including (inclusive) and excluding (exclusive) the functions it called,
+ * followed by the lines which received the most samples. Time spent in
+ * builtin functions counts as time of the function calling them.
+ *
+ * Sampling requires setitimer() and is only available on Unix like
+ * systems. Elsewhere the report contains only the functions.
+ *
+ * The calls are also recorded in a call tree, which contains a node for
+ * every distinct call stack. With option -p followed by a filename the
+ * tree is written to this file in the 'collapsed stack' format used by
+ * flame graph tools: one line per call stack with the names of the
+ * functions separated by semicolons, followed by the exclusive time of
+ * the stack in microseconds.
+ *
+ *  demo.x;fib;fib 1234
+ *
+ * 2020	K.W.E. de Lange
+ */
+#if defined(__unix__) || defined(__APPLE__)
+	#define _DEFAULT_SOURCE  /* clock_gettime() is not part of C99 */
+	#define MONOTONIC
+	#define SAMPLING
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef SAMPLING
+#include <sys/time.h>
+#include <signal.h>
+#endif
+
+#include "profile.h"
+#include "error.h"
+#include "vm.h"
+
+#define MAXLINES	20			/* number of lines in the report */
+#define INTERVAL	1000		/* sample interval in microseconds */
+
+
+/* Node in the call tree. The path from the root to a node is a call stack.
+ */
+typedef struct callnode {
+	Code *code;
+	double self;				/* exclusive time spent in this call stack */
+	struct callnode *parent;
+	struct callnode *child;		/* first callee */
+	struct callnode *sibling;	/* next callee of parent */
+} CallNode;
+
+/* Call in progress.
+ */
+typedef struct call {
+	CallNode *node;
+	double start;				/* time of the call */
+	double callees;				/* time spent in callees */
+} Call;
+
+/* Number of samples per line of a module.
+ */
+typedef struct source {
+	Module *module;
+	unsigned long *samples;		/* number of samples per line */
+} Source;
+
+/* Number of samples of a source line.
+ */
+typedef struct line {
+	Module *module;
+	int line;
+	unsigned int offset;		/* offset of the start of the line */
+	unsigned long samples;
+} Line;
+
+
+static CallNode root;			/* root of the call tree, has no code */
+static Call *stack = NULL;		/* calls in progress */
+static int depth = 0;			/* number of calls in progress */
+static int capacity = 0;		/* number of calls allocated */
+
+static Code **codes = NULL;		/* all code objects which were profiled */
+static int ncodes = 0;
+static double started;			/* time profiling started */
+static volatile unsigned long nsamples = 0;
+
+
+/* Return the current time in seconds.
+ */
+static double now(void)
+{
+	#ifdef MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+	#else
+	return (double)clock() / CLOCKS_PER_SEC;
+	#endif
+}
+
+
+/* Allocate the profiling data for a code object which is called for the
+ * first time.
+ */
+static void attach(Code *code)
+{
+	Profile *p;
+	Code **c;
+
+	if ((p = calloc(1, sizeof(Profile))) == NULL)
+		error(OutOfMemoryError);
+
+	if ((p->samples = calloc(code->size + 1, sizeof(unsigned long))) == NULL)
+		error(OutOfMemoryError);
+
+	if ((c = realloc(codes, (ncodes + 1) * sizeof(Code *))) == NULL)
+		error(OutOfMemoryError);
+
+	codes = c;
+	codes[ncodes++] = code;
+
+	code->profile = p;  /* last, as from now on sample() can use it */
+}
+
+
+/* Return the child of node for calls to code, create it if it does not
+ * exist yet.
+ */
+static CallNode *callee(CallNode *node, Code *code)
+{
+	CallNode *n;
+
+	for (n = node->child; n; n = n->sibling)
+		if (n->code == code)
+			return n;
+
+	if ((n = calloc(1, sizeof(CallNode))) == NULL)
+		error(OutOfMemoryError);
+
+	n->code = code;
+	n->parent = node;
+	n->sibling = node->child;
+	node->child = n;
+
+	return n;
+}
+
+
+/* A code object is called.
+ */
+void profile_enter(Code *code)
+{
+	Call *s;
+
+	if (code->profile == NULL)
+		attach(code);
+
+	if (depth == capacity) {
+		capacity = capacity ? capacity * 2 : 64;
+		if ((s = realloc(stack, capacity * sizeof(Call))) == NULL)
+			error(OutOfMemoryError);
+		stack = s;
+	}
+
+	s = &stack[depth];
+	s->node = callee(depth ? stack[depth - 1].node : &root, code);
+	s->callees = 0;
+
+	code->profile->calls++;
+	code->profile->active++;
+
+	depth++;
+
+	s->start = now();
+}
+
+
+/* The code object which was called last returns.
+ */
+void profile_leave(void)
+{
+	double elapsed, self;
+	Call *s;
+	Profile *p;
+
+	if (depth == 0)
+		return;
+
+	s = &stack[--depth];
+	p = s->node->code->profile;
+
+	elapsed = now() - s->start;
+	self = elapsed - s->callees;
+
+	s->node->self += self;
+	p->exclusive += self;
+
+	if (--p->active == 0)  /* in recursion only the outermost call counts */
+		p->inclusive += elapsed;
+
+	if (depth)
+		stack[depth - 1].callees += elapsed;
+}
+
+
+#ifdef SAMPLING
+/* Signal handler for the profiling timer, takes a sample.
+ */
+static void sample(int signum)
+{
+	Code *code;
+	int index;
+
+	(void)signum;
+
+	if ((code = vm_current(&index)) != NULL && code->profile != NULL)
+		if (index >= 0 && index <= code->size)
+			code->profile->samples[index]++;
+
+	nsamples++;
+}
+
+
+/* Block (how = SIG_BLOCK) or unblock (how = SIG_UNBLOCK) the profiling
+ * timer signal.
+ */
+static void mask(int how)
+{
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGPROF);
+	sigprocmask(how, &set, NULL);
+}
+
+
+/* Start (interval > 0) or stop (interval = 0) the profiling timer.
+ */
+static void timer(long interval)
+{
+	struct itimerval it;
+
+	it.it_interval.tv_sec = 0;
+	it.it_interval.tv_usec = interval;
+	it.it_value = it.it_interval;
+
+	setitimer(ITIMER_PROF, &it, NULL);
+}
+#endif
+
+
+static int by_exclusive(const void *a, const void *b)
+{
+	double x = (*(Code **)a)->profile->exclusive;
+	double y = (*(Code **)b)->profile->exclusive;
+
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+
+static int by_samples(const void *a, const void *b)
+{
+	unsigned long x = ((Line *)a)->samples;
+	unsigned long y = ((Line *)b)->samples;
+
+	return x < y ? 1 : x > y ? -1 : 0;
+}
+
+
+/* Collect the samples per line from the samples per instruction.
+ *
+ * return	array with sampled lines, *n is set to the number of lines
+ */
+static Line *lines(int *n)
+{
+	Source *src = NULL, *s;
+	Line *line = NULL, *t;
+	int nsources = 0, count = 0, l;
+	Code *code;
+
+	for (int c = 0; c < ncodes; c++) {
+		code = codes[c];
+		for (s = src; s < src + nsources; s++)
+			if (s->module == code->module)
+				break;
+		if (s == src + nsources) {
+			if ((s = realloc(src, (nsources + 1) * sizeof(Source))) == NULL)
+				error(OutOfMemoryError);
+			src = s;
+			s = &src[nsources++];
+			s->module = code->module;
+			s->module->line(s->module, 0);  /* builds the line index */
+			if ((s->samples = calloc(s->module->nlines, sizeof(unsigned long))) == NULL)
+				error(OutOfMemoryError);
+		}
+		for (int i = 0; i < code->size; i++)
+			if (code->profile->samples[i])
+				s->samples[s->module->line(s->module, code->offset[i]) - 1] += code->profile->samples[i];
+	}
+
+	for (s = src; s < src + nsources; s++) {
+		for (l = 0; l < s->module->nlines; l++)
+			if (s->samples[l]) {
+				if ((t = realloc(line, (count + 1) * sizeof(Line))) == NULL)
+					error(OutOfMemoryError);
+				line = t;
+				line[count].module = s->module;
+				line[count].line = l + 1;
+				line[count].offset = s->module->lines[l];
+				line[count++].samples = s->samples[l];
+			}
+		free(s->samples);
+	}
+
+	free(src);
+
+	*n = count;
+
+	return line;
+}
+
+
+/* Write the call stacks ending in node and its callees to fp.
+ *
+ * path		names of the functions from the root to node, separated by ';'
+ */
+static void collapse(FILE *fp, CallNode *node, char *path, size_t len)
+{
+	size_t n = strlen(node->code->name);
+	char *p;
+
+	if ((p = malloc(len + n + 2)) == NULL)
+		error(OutOfMemoryError);
+
+	memcpy(p, path, len);
+	if (len)
+		p[len++] = ';';
+	memcpy(p + len, node->code->name, n);
+	len += n;
+	p[len] = '\0';
+
+	if (node->self * 1e6 >= 1)
+		fprintf(fp, "%s %.0f\n", p, node->self * 1e6);
+
+	for (CallNode *c = node->child; c; c = c->sibling)
+		collapse(fp, c, p, len);
+
+	free(p);
+}
+
+
+/* Print the report at the end of the program. Calls which are still in
+ * progress (when the program stopped because of an error) are ended first.
+ */
+static void report(void)
+{
+	Line *line;
+	FILE *fp;
+	int n;
+
+	#ifdef SAMPLING
+	timer(0);
+	#endif
+
+	while (depth)
+		profile_leave();
+
+	fprintf(stderr, "\nprofile: %.6f s, %lu samples\n\n", now() - started, nsamples);
+	fprintf(stderr, "%-24s %12s %14s %14s\n", "function", "calls", "inclusive (s)", "exclusive (s)");
+
+	qsort(codes, ncodes, sizeof(Code *), by_exclusive);
+
+	for (int i = 0; i < ncodes; i++)
+		fprintf(stderr, "%-24s %12lu %14.6f %14.6f\n", codes[i]->name, \
+				codes[i]->profile->calls, codes[i]->profile->inclusive, \
+				codes[i]->profile->exclusive);
+
+	line = lines(&n);
+
+	qsort(line, n, sizeof(Line), by_samples);
+
+	if (n)
+		fprintf(stderr, "\n%-24s %12s %7s  %s\n", "line", "samples", "%", "code");
+
+	for (int i = 0; i < n && i < MAXLINES; i++) {
+		char *p = line[i].module->code + line[i].offset;
+		char *e = p;
+		char where[256];
+
+		while (*p == ' ' || *p == '\t')
+			p++;
+		for (e = p; *e && *e != '\n' && *e != '\r'; e++)
+			;
+		snprintf(where, sizeof(where), "%s:%d", line[i].module->name, line[i].line);
+		fprintf(stderr, "%-24s %12lu %7.1f  %.*s\n", where, line[i].samples, \
+				100.0 * line[i].samples / nsamples, (int)(e - p), p);
+	}
+
+	free(line);
+
+	if (config.stacks) {
+		if ((fp = fopen(config.stacks, "w")) == NULL)
+			fprintf(stderr, "profile: cannot write %s\n", config.stacks);
+		else {
+			for (CallNode *c = root.child; c; c = c->sibling)
+				collapse(fp, c, "", 0);
+			fclose(fp);
+		}
+	}
+}
+
+
+/* Postpone taking samples, e.g. while the call stack is being moved.
+ */
+void profile_suspend(void)
+{
+	#ifdef SAMPLING
+	mask(SIG_BLOCK);
+	#endif
+}
+
+
+/* Take the samples which were postponed and continue sampling.
+ */
+void profile_resume(void)
+{
+	#ifdef SAMPLING
+	mask(SIG_UNBLOCK);
+	#endif
+}
+
+
+/* Start profiling. The report is printed when the program exits, also
+ * when it exits because of an error.
+ */
+void profile_start(void)
+{
+	#ifdef SAMPLING
+	struct sigaction sa;
+	#endif
+
+	started = now();
+	atexit(report);
+
+	#ifdef SAMPLING
+	sa.sa_handler = sample;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, NULL);
+
+	timer(INTERVAL);
+	#endif
+}
@@ -0,0 +1,26 @@
+/* profile.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _PROFILE_
+#define _PROFILE_
+
+#include "code.h"
+
+/* Profiling data of a code object.
+ */
+typedef struct profile {
+	unsigned long *samples;		/* number of samples per instruction */
+	unsigned long calls;		/* number of calls */
+	double inclusive;			/* seconds spent in the code and its callees */
+	double exclusive;			/* seconds spent in the code itself */
+	int active;					/* number of calls in progress (recursion) */
+} Profile;
+
+extern void profile_start(void);
+extern void profile_enter(Code *code);
+extern void profile_leave(void);
+extern void profile_suspend(void);
+extern void profile_resume(void);
+
+#endif
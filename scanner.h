@@ -1,60 +1,77 @@
-/* scanner.h
- *
- * 2018	K.W.E. de Lange
- */
-#ifndef _SCANNER_
-#define _SCANNER_
-
-#include <stdbool.h>
-#include "config.h"
-
-typedef enum { 	UNKNOWN=0, CHAR, INT, FLOAT, STR, STAR, SLASH,
-				PLUS, MINUS, EQEQUAL, NOTEQUAL, LESS, LESSEQUAL, GREATER,
-				GREATEREQUAL, COMMA, RPAR, ELSE, DO, LPAR, EQUAL, NUMBER,
-				IDENTIFIER, IF, WHILE, INPUT, PRINT, DEFCHAR, DEFINT,
-				DEFFLOAT, DEFSTR, DEFFUNC, DOT, ENDMARKER, RETURN, PERCENT,
-				AND, OR, PLUSEQUAL, MINUSEQUAL, STAREQUAL, SLASHEQUAL,
-				PERCENTEQUAL, NOT, LSQB, RSQB, NEWLINE, INDENT, DEDENT,
-				PASS, BREAK, CONTINUE, DEFLIST, COLON, IMPORT, FOR, IN } token_t;
-
-static inline char *tokenName(token_t t)  /* 'inline' requires at least C99 */
-{
-	static char *string[] = {
-	"UNKNOWN TOKEN", "CHARACTER LITERAL", "INTEGER LITERAL", "FLOAT LITERAL",
-	"STRING LITERAL", "STAR", "DIV", "PLUS", "MINUS", "EQEQUAL", "NOTEQUAL",
-	"LESS", "LESSEQUAL", "GREATER", "GREATEREQUAL", "COMMA", "RPAR", "ELSE",
-	"DO", "LPAR", "EQUAL", "NUMBER", "IDENTIFIER", "IF", "WHILE", "INPUT",
-	"PRINT", "DEFCHAR", "DEFINT", "DEFFLOAT", "DEFSTR", "DEFFUNC", "DOT",
-	"ENDMARKER", "RETURN", "PERCENT", "AND", "OR", "PLUSEQUAL", "MINUSEQUAL",
-	"STAREQUAL", "SLASHEQUAL", "PERCENTEQUAL", "NOT", "LSQB", "RSQB",
-	"NEWLINE", "INDENT", "DEDENT", "PASS", "BREAK", "CONTINUE", "DEFLIST",
-	"COLON", "IMPORT", "FOR", "IN" };
-	return string[t];
-}
-
-
-/* This struct is the API to the scanner object, containing both data and
- * function adresses.
- *
- * Function next() reads the next token, and places it in variable 'token'.
- * If the token is an identifier or literal then 'string' points to the text.
- * Function peek() looks one token ahead without actually reading it.
- * Variable 'peeked' is used to temporarily store the peeked token, and is for
- * internal use only.
- */
-typedef struct scanner {
-	token_t token;
-	token_t peeked;		/* private */
-	bool at_bol;
-	char string[BUFSIZE + 1];
-
-	token_t (*next)(void);
-	token_t (*peek)(void);
-	void (*init)(struct scanner *);
-	void (*save)(struct scanner *);
-	void (*jump)(struct scanner *);
-} Scanner;
-
-extern Scanner scanner;
-
-#endif
+/* scanner.h
+ *
+ * 2018	K.W.E. de Lange
+ */
+#ifndef _SCANNER_
+#define _SCANNER_
+
+#include <stdbool.h>
+#include "config.h"
+#include "module.h"
+
+typedef enum { 	UNKNOWN=0, CHAR, INT, FLOAT, STR, STAR, SLASH,
+				PLUS, MINUS, EQEQUAL, NOTEQUAL, LESS, LESSEQUAL, GREATER,
+				GREATEREQUAL, COMMA, RPAR, ELSE, DO, LPAR, EQUAL, NUMBER,
+				IDENTIFIER, IF, WHILE, INPUT, PRINT, DEFCHAR, DEFINT,
+				DEFFLOAT, DEFSTR, DEFFUNC, DOT, ENDMARKER, RETURN, PERCENT,
+				AND, OR, PLUSEQUAL, MINUSEQUAL, STAREQUAL, SLASHEQUAL,
+				PERCENTEQUAL, NOT, LSQB, RSQB, NEWLINE, INDENT, DEDENT,
+				PASS, BREAK, CONTINUE, DEFLIST, COLON, IMPORT, FOR, IN } token_t;
+
+static inline char *tokenName(token_t t)  /* 'inline' requires at least C99 */
+{
+	static char *string[] = {
+	"UNKNOWN TOKEN", "CHARACTER LITERAL", "INTEGER LITERAL", "FLOAT LITERAL",
+	"STRING LITERAL", "STAR", "DIV", "PLUS", "MINUS", "EQEQUAL", "NOTEQUAL",
+	"LESS", "LESSEQUAL", "GREATER", "GREATEREQUAL", "COMMA", "RPAR", "ELSE",
+	"DO", "LPAR", "EQUAL", "NUMBER", "IDENTIFIER", "IF", "WHILE", "INPUT",
+	"PRINT", "DEFCHAR", "DEFINT", "DEFFLOAT", "DEFSTR", "DEFFUNC", "DOT",
+	"ENDMARKER", "RETURN", "PERCENT", "AND", "OR", "PLUSEQUAL", "MINUSEQUAL",
+	"STAREQUAL", "SLASHEQUAL", "PERCENTEQUAL", "NOT", "LSQB", "RSQB",
+	"NEWLINE", "INDENT", "DEDENT", "PASS", "BREAK", "CONTINUE", "DEFLIST",
+	"COLON", "IMPORT", "FOR", "IN" };
+	return string[t];
+}
+
+
+/* A module is converted into an array of tokens once, when it is loaded.
+ * Every token records where in the code it was found, and if it is an
+ * identifier or a literal, its text. The text is interned (see intern.c),
+ * so equal texts share the same pointer. Tokens without text refer to the
+ * empty string. INDENT and DEDENT tokens are resolved during conversion.
+ */
+typedef struct token {
+	token_t token;
+	unsigned int offset;	/* offset of token in module code */
+	char *string;			/* interned token text */
+} Token;
+
+
+/* This struct is the API to the scanner object, containing both data and
+ * function adresses.
+ *
+ * Function tokenize() converts the code of a module into an array of tokens.
+ * Function next() reads the next token from the array of the module the
+ * reader is currently in, and places it in variable 'token'. If the token
+ * is an identifier or literal then 'string' points to the text.
+ * Function peek() looks one token ahead without actually reading it; as a
+ * side effect 'string' then points to the text of the peeked token.
+ * Variable 'pos' is the index of the next token to read, and is for
+ * internal use only.
+ */
+typedef struct scanner {
+	token_t token;
+	char *string;
+	size_t pos;			/* private */
+
+	token_t (*next)(void);
+	token_t (*peek)(void);
+	void (*init)(struct scanner *);
+	void (*save)(struct scanner *);
+	void (*jump)(struct scanner *);
+	void (*tokenize)(struct module *);
+} Scanner;
+
+extern Scanner scanner;
+
+#endif
@@ -1,222 +1,365 @@
-/* string.c
- *
- * String object operations
- *
- * 2016 K.W.E. de Lange
- */
-#include <stdlib.h>
-#include <string.h>
-
-#include "strndup.h"
-#include "strdup.h"
-#include "error.h"
-#include "str.h"
-
-
-static StrObject *str_alloc(void)
-{
-	StrObject *obj;
-
-	if ((obj = calloc(1, sizeof(StrObject))) == NULL)
-		error(OutOfMemoryError);
-
-	obj->typeobj = (TypeObject *)&strtype;
-	obj->type = STR_T;
-	obj->refcount = 0;
-
-	if ((obj->sptr = strdup("")) == NULL)  /* initial value is empty string */
-		error(OutOfMemoryError);
-
-	return obj;
-}
-
-
-static void str_free(StrObject *obj)
-{
-	free(obj->sptr);
-	free(obj);
-}
-
-
-static void str_print(StrObject *obj)
-{
-	printf("%s", obj->sptr);
-}
-
-
-static StrObject *str_set(StrObject *obj, const char *s)
-{
-	if (obj->sptr != NULL)
-		free(obj->sptr);
-
-	if ((obj->sptr = strdup(s)) == NULL)
-		error(OutOfMemoryError);
-
-	return obj;
-}
-
-
-static StrObject *str_vset(StrObject *obj, va_list argp)
-{
-	return str_set(obj, va_arg(argp, char *));
-}
-
-
-/* Operand op1 or op2 is a string. The other operand can be anything and
- * will be converted to a string.
- */
-static Object *str_concat(Object *op1, Object *op2)
-{
-	char *s;
-	size_t bytes;
-	Object *obj, *conv = NULL;
-
-	op1 = TYPE(op1) == STR_T ? op1 : (conv = obj_to_strobj(op1));
-	op2 = TYPE(op2) == STR_T ? op2 : (conv = obj_to_strobj(op2));
-
-	bytes = strlen(obj_as_str(op1)) + strlen(obj_as_str(op2)) + 1;
-
-	if ((s = calloc(bytes, sizeof(char))) == NULL)
-		error(OutOfMemoryError);
-
-	strcpy(s, obj_as_str(op1));
-	strcat(s, obj_as_str(op2));
-
-	obj = obj_create(STR_T, s);
-
-	free(s);
-
-	if (conv)
-		obj_free(conv);
-
-	return obj;
-}
-
-
-static int_t length(StrObject *obj)
-{
-	return strlen(obj_as_str((Object *)obj));
-}
-
-
-static Object *str_length(StrObject *obj)
-{
-	return obj_create(INT_T, length(obj));
-}
-
-
-static Object *str_repeat(Object *op1, Object *op2)
-{
-	char *str;
-    int_t times;
-	size_t bytes;
-	Object *obj;
-
-	Object *s = TYPE(op1) == STR_T ? op1 : op2;
-	Object *n = TYPE(op1) == STR_T ? op2 : op1;
-
-	times = obj_as_int(n);
-
-	if (times < 0)
-		times = 0;
-
-	bytes = (size_t)length((StrObject *)s) * times + 1;
-
-	if ((str = calloc(bytes, sizeof(char))) == NULL)
-		error(OutOfMemoryError);
-
-	while (times--)
-		strcat(str, obj_as_str(s));
-
-	obj = obj_create(STR_T, str);
-
-	free(str);
-
-	return obj;
-}
-
-
-static Object *str_eql(Object *op1, Object *op2)
-{
-	int result = strcmp(obj_as_str(op1), obj_as_str(op2)) == 0 ? 1 : 0;
-
-	return obj_create(INT_T, (int_t)result);
-}
-
-
-static Object *str_neq(Object *op1, Object *op2)
-{
-	int result = strcmp(obj_as_str(op1), obj_as_str(op2)) == 0 ? 1 : 0;
-
-	return obj_create(INT_T, (int_t)!result);
-}
-
-
-static CharObject *str_item(StrObject *str, int index)
-{
-	CharObject *obj;
-	int_t len;
-
-	len = length(str);
-
-	if (index < 0)
-		index += len;
-
-	if (index < 0 || index >= len)
-		return NULL;  /* IndexError: index out of range */
-
-	obj = (CharObject *)obj_create(CHAR_T, *(obj_as_str((Object *)str) + index));
-
-	return obj;
-}
-
-
-static StrObject *str_slice(StrObject *obj, int start, int end)
-{
-	StrObject *slice;
-	char *src, *dst;
-	int_t len;
-
-	len = length(obj);
-
-	if (start < 0)
-		start += len;
-
-	if (end < 0)
-		end += len;
-
-	if (start < 0)
-		start = 0;
-
-	if (end >= len)
-		end = len;
-
-	src = obj_as_str((Object *)obj);
-	dst = strndup(src + start, end - start);
-
-	slice = (StrObject *)obj_create(STR_T, dst);
-
-	free(dst);
-
-	return slice;
-}
-
-
-/* String object API.
- */
-StrType strtype = {
-	.name = "str",
-	.alloc = (Object *(*)())str_alloc,
-	.free = (void (*)(Object *))str_free,
-	.print = (void (*)(Object *))str_print,
-	.set = (Object *(*)())str_set,
-	.vset = (Object *(*)(Object *, va_list))str_vset,
-
-	.length = str_length,
-	.item = str_item,
-	.slice = str_slice,
-	.concat = str_concat,
-	.repeat = str_repeat,
-	.eql = str_eql,
-	.neq = str_neq
-	};
+/* string.c
+ *
+ * String object operations
+ *
+ * The text of a string object is either owned by the object, or it is an
+ * interned string which is shared with other objects. Interned strings
+ * are never modified or freed. Literals are interned, so copying them is
+ * cheap and comparing them is a pointer comparison.
+ *
+ * Every string object knows the length of its text, so operations never
+ * have to search for the terminating '\0'. As a consequence a string may
+ * contain '\0' characters. Owned text is always '\0' terminated as well,
+ * so it can be used as a C string.
+ *
+ * Copying a string does not copy its text. Owned text has a reference
+ * count and is shared by the copies. The text of a string object is never
+ * changed in place while it is shared; a string which gets a new value
+ * and shares its text with other strings gets a new buffer instead
+ * (copy-on-write).
+ *
+ * 2016 K.W.E. de Lange
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "output.h"
+#include "error.h"
+#include "pool.h"
+#include "str.h"
+
+
+/* Owned text is preceded by the number of string objects sharing it.
+ */
+typedef struct text {
+	int refcount;
+	char text[];
+} Text;
+
+#define TEXT(s)	((Text *)((s) - offsetof(Text, text)))
+
+static Pool pool = POOL("str", StrObject);
+
+
+static StrObject *str_alloc(void)
+{
+	StrObject *obj = pool_alloc(&pool);
+
+	obj->type = STR_T;
+	obj->refcount = 0;
+
+	obj->sptr = intern("");  /* initial value is empty string */
+	obj->len = 0;
+	obj->capacity = 0;
+	obj->interned = true;
+
+	return obj;
+}
+
+
+/* Release the text of obj. The text is freed when it is no longer shared.
+ */
+static void release(StrObject *obj)
+{
+	if (obj->interned == false && --TEXT(obj->sptr)->refcount == 0)
+		free(TEXT(obj->sptr));
+}
+
+
+/* Allocate a new (unshared) buffer for a text of len characters plus the
+ * terminating '\0'.
+ */
+static char *text_alloc(size_t len)
+{
+	Text *t;
+
+	if ((t = malloc(offsetof(Text, text) + len + 1)) == NULL)
+		error(OutOfMemoryError);
+
+	t->refcount = 1;
+
+	return t->text;
+}
+
+
+static void str_free(StrObject *obj)
+{
+	release(obj);
+	pool_free(&pool, obj);
+}
+
+
+static void str_print(StrObject *obj)
+{
+	output_write(obj->sptr, obj->len);
+}
+
+
+/* Make sure obj owns an unshared buffer which can hold a text of len
+ * characters plus the terminating '\0'. The current text is not preserved.
+ */
+static void reserve(StrObject *obj, size_t len)
+{
+	if (obj->interned || TEXT(obj->sptr)->refcount > 1 || obj->capacity < len + 1) {
+		release(obj);
+		obj->sptr = text_alloc(len);
+		obj->capacity = len + 1;
+		obj->interned = false;
+	}
+}
+
+
+/* Set the text of obj to the first len characters of s.
+ */
+static StrObject *str_set_n(StrObject *obj, const char *s, size_t len)
+{
+	char *t;
+
+	if (s >= obj->sptr && s <= obj->sptr + obj->len) {  /* s is (part of) the text of obj */
+		t = text_alloc(len);
+		memcpy(t, s, len);
+		release(obj);
+		obj->sptr = t;
+		obj->capacity = len + 1;
+		obj->interned = false;
+	} else {
+		reserve(obj, len);
+		memcpy(obj->sptr, s, len);
+	}
+
+	obj->sptr[len] = '\0';
+	obj->len = len;
+
+	return obj;
+}
+
+
+static StrObject *str_set(StrObject *obj, const char *s)
+{
+	return str_set_n(obj, s, strlen(s));
+}
+
+
+static StrObject *str_vset(StrObject *obj, va_list argp)
+{
+	return str_set(obj, va_arg(argp, char *));
+}
+
+
+/* Set the text of obj to interned string s, without copying it.
+ */
+static StrObject *str_share(StrObject *obj, char *s)
+{
+	release(obj);
+
+	obj->sptr = s;
+	obj->len = intern_length(s);
+	obj->capacity = 0;
+	obj->interned = true;
+
+	return obj;
+}
+
+
+/* Set the text of obj to the text of src. The text is shared, not copied.
+ */
+static StrObject *str_assign(StrObject *obj, StrObject *src)
+{
+	if (src->interned)
+		return str_share(obj, src->sptr);
+
+	if (obj == src)
+		return obj;
+
+	TEXT(src->sptr)->refcount++;  /* before release(), src may share the text of obj */
+	release(obj);
+
+	obj->sptr = src->sptr;
+	obj->len = src->len;
+	obj->capacity = src->capacity;
+	obj->interned = false;
+
+	return obj;
+}
+
+
+/* Create a new string object with room for a text of len characters.
+ * The caller must fill in the text.
+ */
+static StrObject *str_new(size_t len)
+{
+	StrObject *obj = (StrObject *)obj_alloc(STR_T);
+
+	reserve(obj, len);
+
+	obj->sptr[len] = '\0';
+	obj->len = len;
+
+	return obj;
+}
+
+
+/* Operand op1 or op2 is a string. The other operand can be anything and
+ * will be converted to a string.
+ */
+static Object *str_concat(Object *op1, Object *op2)
+{
+	StrObject *s1, *s2, *obj;
+
+	s1 = (StrObject *)obj_to_strobj(op1);
+	s2 = (StrObject *)obj_to_strobj(op2);
+
+	obj = str_new(s1->len + s2->len);
+
+	memcpy(obj->sptr, s1->sptr, s1->len);
+	memcpy(obj->sptr + s1->len, s2->sptr, s2->len);
+
+	obj_decref(s1);
+	obj_decref(s2);
+
+	return (Object *)obj;
+}
+
+
+static int_t length(StrObject *obj)
+{
+	return (int_t)obj->len;
+}
+
+
+static Object *str_length(StrObject *obj)
+{
+	return inttype.value(length(obj));
+}
+
+
+static Object *str_repeat(Object *op1, Object *op2)
+{
+	StrObject *obj;
+	int_t times;
+
+	StrObject *s = (StrObject *)(TYPE(op1) == STR_T ? op1 : op2);
+	Object *n = TYPE(op1) == STR_T ? op2 : op1;
+
+	times = obj_as_int(n);
+
+	if (times < 0)
+		times = 0;
+
+	obj = str_new(s->len * times);
+
+	for (int_t i = 0; i < times; i++)
+		memcpy(obj->sptr + i * s->len, s->sptr, s->len);
+
+	return (Object *)obj;
+}
+
+
+/* Compare the texts of two objects. If both are interned strings the
+ * pointers are compared.
+ */
+static int equal(Object *op1, Object *op2)
+{
+	StrObject *s1, *s2;
+
+	if (TYPE(op1) != STR_T || TYPE(op2) != STR_T)
+		return strcmp(obj_as_str(op1), obj_as_str(op2)) == 0 ? 1 : 0;
+
+	s1 = (StrObject *)op1;
+	s2 = (StrObject *)op2;
+
+	if (s1->interned && s2->interned)
+		return s1->sptr == s2->sptr;
+
+	return s1->len == s2->len && memcmp(s1->sptr, s2->sptr, s1->len) == 0 ? 1 : 0;
+}
+
+
+static Object *str_eql(Object *op1, Object *op2)
+{
+	int result = equal(op1, op2);
+
+	return inttype.value((int_t)result);
+}
+
+
+static Object *str_neq(Object *op1, Object *op2)
+{
+	int result = equal(op1, op2);
+
+	return inttype.value((int_t)!result);
+}
+
+
+static CharObject *str_item(StrObject *str, int index)
+{
+	CharObject *obj;
+	int_t len;
+
+	len = length(str);
+
+	if (index < 0)
+		index += len;
+
+	if (index < 0 || index >= len)
+		return NULL;  /* IndexError: index out of range */
+
+	obj = (CharObject *)obj_create(CHAR_T, str->sptr[index]);
+
+	return obj;
+}
+
+
+static StrObject *str_slice(StrObject *obj, int start, int end)
+{
+	StrObject *slice;
+	int_t len;
+
+	len = length(obj);
+
+	if (start < 0)
+		start += len;
+
+	if (end < 0)
+		end += len;
+
+	if (start < 0)
+		start = 0;
+
+	if (end >= len)
+		end = len;
+
+	if (start >= end)
+		return (StrObject *)obj_alloc(STR_T);
+
+	slice = str_new(end - start);
+
+	memcpy(slice->sptr, obj->sptr + start, end - start);
+
+	return slice;
+}
+
+
+/* String object API.
+ */
+StrType strtype = {
+	.name = "str",
+	.alloc = (Object *(*)())str_alloc,
+	.free = (void (*)(Object *))str_free,
+	.print = (void (*)(Object *))str_print,
+	.set = (Object *(*)())str_set,
+	.vset = (Object *(*)(Object *, va_list))str_vset,
+
+	.length = str_length,
+	.item = str_item,
+	.slice = str_slice,
+	.concat = str_concat,
+	.repeat = str_repeat,
+	.eql = str_eql,
+	.neq = str_neq,
+	.share = str_share,
+	.assign = str_assign,
+	.set_n = str_set_n
+	};
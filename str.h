@@ -1,28 +1,34 @@
-/* str.h
- *
- * 2016 K.W.E. de Lange
- */
-#ifndef _STR_
-#define _STR_
-#include "object.h"
-#include "number.h"
-
-typedef struct {
-	OBJ_HEAD;
-	char *sptr;
-} StrObject;
-
-typedef struct {
-	TYPE_HEAD;
-	Object *(*length)(StrObject *obj);
-	CharObject *(*item)(StrObject *str, int index);
-	StrObject *(*slice)(StrObject *obj, int start, int end);
-	Object *(*concat)(Object *op1, Object *op2);
-	Object *(*repeat)(Object *op1, Object *op2);
-	Object *(*eql)(Object *op1, Object *op2);
-	Object *(*neq)(Object *op1, Object *op2);
-} StrType;
-
-extern StrType strtype;
-
-#endif
+/* str.h
+ *
+ * 2016 K.W.E. de Lange
+ */
+#ifndef _STR_
+#define _STR_
+#include "object.h"
+#include "number.h"
+
+typedef struct {
+	OBJ_HEAD;
+	char *sptr;
+	size_t len;			/* number of characters, excluding '\0' */
+	size_t capacity;	/* number of bytes allocated for sptr, 0 if interned */
+	bool interned;		/* sptr is an interned string (see intern.c) */
+} StrObject;
+
+typedef struct {
+	TYPE_HEAD;
+	Object *(*length)(StrObject *obj);
+	CharObject *(*item)(StrObject *str, int index);
+	StrObject *(*slice)(StrObject *obj, int start, int end);
+	Object *(*concat)(Object *op1, Object *op2);
+	Object *(*repeat)(Object *op1, Object *op2);
+	Object *(*eql)(Object *op1, Object *op2);
+	Object *(*neq)(Object *op1, Object *op2);
+	StrObject *(*share)(StrObject *obj, char *s);
+	StrObject *(*assign)(StrObject *obj, StrObject *src);
+	StrObject *(*set_n)(StrObject *obj, const char *s, size_t len);
+} StrType;
+
+extern StrType strtype;
+
+#endif
@@ -1,12 +1,12 @@
-/* strdup.h
- *
- * 1994	K.W.E. de Lange
- */
-#ifndef _STRDUP_
-#define _STRDUP_
-
-#include <stddef.h>
-
-extern char *strdup(const char *s);
-
-#endif
+/* strdup.h
+ *
+ * 1994	K.W.E. de Lange
+ */
+#ifndef _STRDUP_
+#define _STRDUP_
+
+#include <stddef.h>
+
+extern char *strdup(const char *s);
+
+#endif
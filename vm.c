@@ -0,0 +1,832 @@
+/* vm.c
+ *
+ * Virtual machine which executes bytecode (see code.h).
+ *
+ * The virtual machine is stack based. Objects on the stack are references
+ * with their reference count incremented, exactly like the return values
+ * of the obj_... functions.
+ *
+ * Every execution of a code object - a module or a function - gets a frame
+ * on the call stack. A frame only records which code is executed, the
+ * instruction being executed and where its local identifiers and its part
+ * of the value stack start. Local identifiers are stored in one array which
+ * is shared by all frames, and are indexed by the local slot. The value
+ * stacks of the frames are stored after each other in another array.
+ * These three arrays grow when needed and are never released, so calling
+ * a function does not allocate memory. Function calls do not call run()
+ * recursively, run() just switches to the frame of the function.
+ *
+ * As the arrays can move when they grow, frames refer to the arrays with
+ * indices. Pointers into the arrays are recalculated when switching frames.
+ *
+ * The arguments of a function call are left on the value stack of the
+ * caller, directly below the value stack of the function. BIND_ARG binds
+ * them to the local identifiers of the function. A function receives a
+ * copy of every argument; if an argument is a temporary value which is
+ * referenced only by the stack, it is moved instead of copied.
+ *
+ * Module code declares its identifiers at global level, also when the
+ * module is imported from within a function.
+ *
+ * If the compiler supports it (GCC and clang do) the instructions are
+ * dispatched via a table with label addresses (computed goto), otherwise
+ * a switch statement is used.
+ *
+ * 2020	K.W.E. de Lange
+ */
+#include <limits.h>
+#include <stdlib.h>
+
+#include "identifier.h"
+#include "position.h"
+#include "function.h"
+#include "reader.h"
+#include "scanner.h"
+#include "number.h"
+#include "output.h"
+#include "error.h"
+#include "profile.h"
+#include "code.h"
+#include "str.h"
+#include "vm.h"
+
+
+#if defined(__GNUC__) && !defined(NO_COMPUTED_GOTO)
+	#define COMPUTED_GOTO
+#endif
+
+
+/* The code which is being executed. Pc is the address of the instruction
+ * which is being executed and is used when reporting errors and to find
+ * the return address of a function call.
+ */
+typedef struct frame {
+	Code *code;
+	instr_t *pc;
+	int local;					/* index of first local identifier */
+	int stack;					/* index of bottom of value stack */
+	int sp;						/* index of top of value stack when calling */
+	int args;					/* index of first argument on value stack */
+	int argc;					/* number of arguments */
+	int bound;					/* number of arguments bound to a local */
+} Frame;
+
+static Frame *frames = NULL;		/* call stack */
+static int depth = 0;				/* number of frames in use */
+static int maxdepth = 0;			/* number of frames allocated */
+
+static Identifier *locals = NULL;	/* local identifiers of all frames */
+static int nlocals = 0;				/* number of local identifiers allocated */
+
+static Object **values = NULL;		/* value stacks of all frames */
+static int nvalues = 0;				/* number of stack entries allocated */
+
+static Frame *frame = NULL;			/* frame being executed, NULL if none */
+
+
+/* Position the reader at the source of the instruction which is being
+ * executed, so error() can report the correct line.
+ */
+void vm_locate(void)
+{
+	if (frame) {
+		reader.current = frame->code->module;
+		reader.pos = reader.current->code + frame->code->offset[frame->pc - frame->code->instr];
+	}
+}
+
+
+/* Return the code which is being executed and set *index to the index of
+ * its current instruction, or return NULL if no code is being executed.
+ * Used by the profiler to take samples, so it can be called from a signal
+ * handler at any moment. Therefore a frame is completely filled in before
+ * it is counted in depth.
+ */
+Code *vm_current(int *index)
+{
+	Frame *f;
+
+	if (depth == 0)
+		return NULL;
+
+	f = &frames[depth - 1];
+	*index = (int)(f->pc - f->code->instr);
+
+	return f->code;
+}
+
+
+/* Return an integer or float object with value v for the result of an
+ * operation on op1. If op1 is a temporary (only referenced by the stack)
+ * it is reused instead of allocating a new object.
+ *
+ * Return: new reference
+ */
+static inline Object *int_result(Object *op1, int_t v)
+{
+	if (op1->refcount == 1) {
+		((IntObject *)op1)->ival = v;
+		obj_incref(op1);
+		return op1;
+	}
+	return inttype.value(v);
+}
+
+
+static inline Object *float_result(Object *op1, float_t v)
+{
+	if (op1->refcount == 1) {
+		((FloatObject *)op1)->fval = v;
+		obj_incref(op1);
+		return op1;
+	}
+	return obj_create(FLOAT_T, v);
+}
+
+
+/* Execute an assignment operator (+=, -=, ...) directly on the value of
+ * target if both target and value are integers or both are floats.
+ *
+ * Return: true if handled, false if the generic route must be taken
+ */
+static inline bool assign_number(opcode_t opcode, Object *target, Object *value)
+{
+	if (TYPE(target) == INT_T && TYPE(value) == INT_T) {
+		int_t *t = &((IntObject *)target)->ival, v = ((IntObject *)value)->ival;
+
+		switch (opcode) {
+			case OP_ADD:	*t += v; return true;
+			case OP_SUB:	*t -= v; return true;
+			case OP_MUL:	*t *= v; return true;
+			case OP_DIV:	if (v == 0) return false; *t /= v; return true;
+			case OP_MOD:	if (v == 0) return false; *t %= v; return true;
+			default:		return false;
+		}
+	}
+	if (TYPE(target) == FLOAT_T && TYPE(value) == FLOAT_T) {
+		float_t *t = &((FloatObject *)target)->fval, v = ((FloatObject *)value)->fval;
+
+		switch (opcode) {
+			case OP_ADD:	*t += v; return true;
+			case OP_SUB:	*t -= v; return true;
+			case OP_MUL:	*t *= v; return true;
+			default:		return false;  /* division keeps its zero check */
+		}
+	}
+	return false;
+}
+
+
+/* Execute a binary operation.
+ *
+ * Return: new reference (with count = 1)
+ */
+static Object *operation(opcode_t opcode, Object *op1, Object *op2)
+{
+	switch (opcode) {
+		case OP_MUL:
+			return obj_mult(op1, op2);
+		case OP_DIV:
+			return obj_divs(op1, op2);
+		case OP_MOD:
+			return obj_mod(op1, op2);
+		case OP_ADD:
+			return obj_add(op1, op2);
+		case OP_SUB:
+			return obj_sub(op1, op2);
+		default:
+			error(SystemError, "unknown operation %d", opcode);
+	}
+	return NULL;
+}
+
+
+/* Make sure an array has room for at least n elements. The capacity is
+ * doubled until it is large enough.
+ */
+static void *reserve(void *array, int *capacity, int n, size_t size)
+{
+	int c;
+
+	if (n <= *capacity)
+		return array;
+
+	for (c = *capacity ? *capacity : 64; c < n; c *= 2)
+		;
+
+	if ((array = realloc(array, c * size)) == NULL)
+		error(OutOfMemoryError);
+
+	*capacity = c;
+
+	return array;
+}
+
+
+/* Push a new frame for the execution of code on the call stack. Its local
+ * identifiers and value stack are placed after those of the current frame.
+ *
+ * stack	index of bottom of value stack for the new frame
+ * return	new frame
+ */
+static Frame *push_frame(Code *code, int stack)
+{
+	int local = depth ? frames[depth - 1].local + frames[depth - 1].code->nlocals : 0;
+	Frame *f;
+
+	if (depth == maxdepth && config.profile) {
+		profile_suspend();  /* the sampler must not read the frames while they move */
+		frames = reserve(frames, &maxdepth, depth + 1, sizeof(Frame));
+		profile_resume();
+	} else
+		frames = reserve(frames, &maxdepth, depth + 1, sizeof(Frame));
+
+	locals = reserve(locals, &nlocals, local + code->nlocals, sizeof(Identifier));
+	values = reserve(values, &nvalues, stack + code->stacksize + 1, sizeof(Object *));
+
+	f = &frames[depth];
+
+	f->code = code;
+	f->pc = code->instr;
+	f->local = local;
+	f->stack = stack;
+	f->sp = stack;
+	f->args = stack;
+	f->argc = 0;
+	f->bound = 0;
+
+	depth++;  /* only now the sampler may see the frame, see vm_current() */
+
+	for (int i = 0; i < code->nlocals; i++) {
+		locals[local + i].name = code->names[i];
+		locals[local + i].object = NULL;
+	}
+
+	if (config.profile)
+		profile_enter(code);
+
+	return f;
+}
+
+
+/* Take an argument from the value stack to bind it to a local identifier.
+ *
+ * arg		stack entry with the argument, is cleared
+ * return	the argument if it is a temporary value, else a copy
+ */
+static Object *argument(Object **arg)
+{
+	Object *copy, *obj = *arg;
+
+	*arg = NULL;
+
+	if (obj->refcount == 1 && (isNumber(obj) || isSequence(obj)))
+		return obj;  /* nobody else refers to obj */
+
+	copy = obj_copy(obj);
+	obj_decref(obj);
+
+	return copy;
+}
+
+
+/* Call a builtin function. User defined functions are called by run().
+ *
+ * id		identifier with the name of the function
+ *
+ * precedence rule: user defined identifiers shadow builtins
+ */
+static Object *call(Identifier *id, int argc, Object *argv[])
+{
+	char *name = id->name;
+	builtin_t function;
+	Object *obj;
+
+	if (id->object != NULL)
+		error(TypeError, "%s is not a function", name);
+
+	if ((function = builtin(name)) == NULL)
+		error(NameError, "identifier %s is not defined", name);
+
+	obj = function(argc, argv);
+
+	for (int i = 0; i < argc; i++)
+		obj_decref(argv[i]);
+
+	return obj;
+}
+
+
+/* Return the list a method is applied to. Raises an error if the object
+ * is not a list.
+ */
+static ListObject *method_list(Object *obj, char *method)
+{
+	obj = isListNode(obj) ? obj_from_listnode(obj) : obj;
+
+	if (TYPE(obj) != LIST_T)
+		error(SyntaxError, "unknown method %s for type %s", method, TYPENAME(obj));
+
+	return (ListObject *)obj;
+}
+
+
+/* Pop an object from the stack and convert it to an integer.
+ */
+static int_t pop_int(Object ***sp)
+{
+	Object *obj = *--(*sp);
+	int_t i;
+
+	i = obj_as_int(obj);
+	obj_decref(obj);
+
+	return i;
+}
+
+
+/* Execute the code of a module, including the functions it calls.
+ *
+ * code		code to execute
+ * return	return value (new reference)
+ */
+static Object *run(Code *code)
+{
+	int entry = depth;  /* run() returns when the call stack is back at this depth */
+	const bool profiling = config.profile;
+	Frame *f = push_frame(code, depth ? frames[depth - 1].sp : 0);
+	Identifier *local;
+	Object **stack, **sp;
+	Object *obj, *op1, *op2, *result;
+	instr_t *pc;
+	instr_t instr;
+	Identifier *id;
+	int_t index, start, end;
+	int argc;
+
+	/* switch to frame f, sp must be set by the caller */
+	#define LOAD_FRAME() \
+				do { \
+					frame = f; \
+					code = f->code; \
+					local = &locals[f->local]; \
+					stack = &values[f->stack]; \
+				} while (0)
+
+	LOAD_FRAME();
+	sp = stack;
+	pc = code->instr;
+
+	#define PUSH(o)		(*sp++ = (Object *)(o))
+	#define POP()		(*--sp)
+	#define TOP()		(sp[-1])
+	#define NAME()		(code->names[OPERAND(instr)])
+
+	/* identifier to use for name n, and identifier to declare name n in */
+	#define VARIABLE(n)	((int)(n) < code->nlocals && local[n].object ? &local[n] : &scope.global[code->global[n]])
+	#define DECLARE(n)	((int)(n) < code->nlocals ? &local[n] : &scope.global[code->global[n]])
+
+	#define BINARY(function) \
+				op2 = POP(); \
+				op1 = POP(); \
+				PUSH(function(op1, op2)); \
+				obj_decref(op1); \
+				obj_decref(op2); \
+				DISPATCH()
+
+	#define IVAL(o)		(((IntObject *)(o))->ival)
+	#define FVAL(o)		(((FloatObject *)(o))->fval)
+
+	/* Arithmetic and comparisons on two integers or two floats are done
+	 * inline, all other operand types take the route via the obj_... functions.
+	 * Integer division is only done inline if the divisor is not 0. */
+	#define ARITHMETIC(op, function) \
+				op2 = POP(); \
+				op1 = POP(); \
+				if (TYPE(op1) == INT_T && TYPE(op2) == INT_T) \
+					result = int_result(op1, IVAL(op1) op IVAL(op2)); \
+				else if (TYPE(op1) == FLOAT_T && TYPE(op2) == FLOAT_T) \
+					result = float_result(op1, FVAL(op1) op FVAL(op2)); \
+				else \
+					result = function(op1, op2); \
+				PUSH(result); \
+				obj_decref(op1); \
+				obj_decref(op2); \
+				DISPATCH()
+
+	#define DIVISION(op, function) \
+				op2 = POP(); \
+				op1 = POP(); \
+				if (TYPE(op1) == INT_T && TYPE(op2) == INT_T && IVAL(op2) != 0) \
+					result = int_result(op1, IVAL(op1) op IVAL(op2)); \
+				else \
+					result = function(op1, op2); \
+				PUSH(result); \
+				obj_decref(op1); \
+				obj_decref(op2); \
+				DISPATCH()
+
+	#define COMPARISON(op, function) \
+				op2 = POP(); \
+				op1 = POP(); \
+				if (TYPE(op1) == INT_T && TYPE(op2) == INT_T) \
+					result = inttype.value(IVAL(op1) op IVAL(op2)); \
+				else if (TYPE(op1) == FLOAT_T && TYPE(op2) == FLOAT_T) \
+					result = inttype.value(FVAL(op1) op FVAL(op2)); \
+				else \
+					result = function(op1, op2); \
+				PUSH(result); \
+				obj_decref(op1); \
+				obj_decref(op2); \
+				DISPATCH()
+
+	#ifdef COMPUTED_GOTO
+		static void *label[] = {
+			&&L_LOAD_CONST, &&L_LOAD_NAME, &&L_BUILD_LIST, &&L_CALL,
+			&&L_INDEX, &&L_SLICE, &&L_INSERT, &&L_APPEND, &&L_REMOVE,
+			&&L_LEN, &&L_BAD_METHOD, &&L_NOT, &&L_NEG, &&L_MUL, &&L_DIV,
+			&&L_MOD, &&L_ADD, &&L_SUB, &&L_LSS, &&L_LEQ, &&L_GTR, &&L_GEQ,
+			&&L_EQL, &&L_NEQ, &&L_IN, &&L_AND, &&L_OR, &&L_ASSIGN, &&L_POP,
+			&&L_JUMP, &&L_JUMP_IF_FALSE, &&L_FOR_NAME, &&L_FOR_PREP,
+			&&L_FOR_NEXT, &&L_FOR_END, &&L_BIND, &&L_DECLARE, &&L_FUNCTION,
+			&&L_BIND_ARG, &&L_PRINT, &&L_PRINT_NEWLINE, &&L_PROMPT,
+			&&L_INPUT, &&L_IMPORT, &&L_RETURN };
+
+		#define TARGET(op)	L_##op:
+		#define DISPATCH()	do { \
+								f->pc = pc; \
+								instr = *pc++; \
+								goto *label[OPCODE(instr)]; \
+							} while (0)
+
+		DISPATCH();
+	#else  /* switch based dispatch */
+		#define TARGET(op)	case OP_##op:
+		#define DISPATCH()	continue
+
+		while (1) {
+			f->pc = pc;
+			instr = *pc++;
+			switch (OPCODE(instr)) {
+	#endif  /* COMPUTED_GOTO */
+
+	TARGET(LOAD_CONST)
+		obj = code->constant[OPERAND(instr)];
+		if (isImmortal(obj)) {
+			obj_incref(obj);
+			PUSH(obj);
+		} else
+			PUSH(obj_copy(obj));
+		DISPATCH();
+
+	TARGET(LOAD_NAME)
+		if ((id = VARIABLE(OPERAND(instr)))->object == NULL)
+			error(NameError, "identifier %s is not defined", NAME());
+		if (isFunction(id->object))
+			error(SyntaxError, "expected %s after function %s", tokenName(LPAR), NAME());
+		obj_incref(id->object);
+		PUSH(id->object);
+		DISPATCH();
+
+	TARGET(BUILD_LIST)
+		obj = obj_alloc(LIST_T);
+		sp -= OPERAND(instr);
+		for (unsigned int i = 0; i < OPERAND(instr); i++) {
+			listtype.append((ListObject *)obj, obj_copy(sp[i]));
+			obj_decref(sp[i]);
+		}
+		PUSH(obj);
+		DISPATCH();
+
+	TARGET(CALL)
+		id = VARIABLE(OPERAND(instr) & 0xFFFF);
+		argc = OPERAND(instr) >> 16;
+		sp -= argc;
+		if (id->object == NULL || !isFunction(id->object)) {
+			result = call(id, argc, sp);
+			PUSH(result);
+			DISPATCH();
+		}
+		debug_printf(DEBUGBLOCK, "\n------: %s %s", "Start function", ((PositionObject *)id->object)->code->name);
+		f->sp = sp - values;
+		f = push_frame(((PositionObject *)id->object)->code, f->sp + argc);
+		f->args = f->stack - argc;
+		f->argc = argc;
+		LOAD_FRAME();
+		sp = stack;
+		pc = code->instr;
+		DISPATCH();
+
+	TARGET(INDEX)
+		index = pop_int(&sp);
+		obj = POP();
+		op1 = isListNode(obj) ? obj_from_listnode(obj) : obj;
+		if (!isSequence(op1))
+			error(TypeError, "%s is not subscriptable", TYPENAME(op1));
+		if ((result = OPERAND(instr) ? obj_item(op1, index) : obj_value(op1, index)) == NULL)
+			error(IndexError);
+		obj_decref(obj);
+		PUSH(result);
+		DISPATCH();
+
+	TARGET(SLICE)
+		end = (OPERAND(instr) & 2) ? pop_int(&sp) : INT_MAX;
+		start = (OPERAND(instr) & 1) ? pop_int(&sp) : 0;
+		obj = POP();
+		op1 = isListNode(obj) ? obj_from_listnode(obj) : obj;
+		if (!isSequence(op1))
+			error(TypeError, "%s is not subscriptable", TYPENAME(op1));
+		if ((result = obj_slice(op1, start, end)) == NULL)
+			error(IndexError);
+		obj_decref(obj);
+		PUSH(result);
+		DISPATCH();
+
+	TARGET(INSERT)
+		op2 = POP();
+		index = pop_int(&sp);
+		obj = POP();
+		listtype.insert(method_list(obj, "insert"), index, obj_copy(op2));
+		obj_decref(op2);
+		obj_decref(obj);
+		PUSH(obj_alloc(NONE_T));
+		DISPATCH();
+
+	TARGET(APPEND)
+		op2 = POP();
+		obj = POP();
+		listtype.append(method_list(obj, "append"), obj_copy(op2));
+		obj_decref(op2);
+		obj_decref(obj);
+		PUSH(obj_alloc(NONE_T));
+		DISPATCH();
+
+	TARGET(REMOVE)
+		index = pop_int(&sp);
+		obj = POP();
+		if ((result = listtype.remove(method_list(obj, "remove"), index)) == NULL)
+			error(IndexError);
+		obj_decref(obj);
+		PUSH(result);
+		DISPATCH();
+
+	TARGET(LEN)
+		obj = POP();
+		op1 = isListNode(obj) ? obj_from_listnode(obj) : obj;
+		if (TYPE(op1) == STR_T)
+			result = strtype.length((StrObject *)op1);
+		else
+			result = listtype.length(method_list(op1, "len"));
+		obj_decref(obj);
+		PUSH(result);
+		DISPATCH();
+
+	TARGET(BAD_METHOD)
+		obj = TOP();
+		obj = isListNode(obj) ? obj_from_listnode(obj) : obj;
+		error(SyntaxError, "unknown method %s for type %s", NAME(), TYPENAME(obj));
+		DISPATCH();
+
+	TARGET(NOT)
+		obj = POP();
+		PUSH(obj_negate(obj));
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(NEG)
+		obj = POP();
+		PUSH(obj_invert(obj));
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(MUL)
+		ARITHMETIC(*, obj_mult);
+	TARGET(DIV)
+		DIVISION(/, obj_divs);
+	TARGET(MOD)
+		DIVISION(%, obj_mod);
+	TARGET(ADD)
+		ARITHMETIC(+, obj_add);
+	TARGET(SUB)
+		ARITHMETIC(-, obj_sub);
+	TARGET(LSS)
+		COMPARISON(<, obj_lss);
+	TARGET(LEQ)
+		COMPARISON(<=, obj_leq);
+	TARGET(GTR)
+		COMPARISON(>, obj_gtr);
+	TARGET(GEQ)
+		COMPARISON(>=, obj_geq);
+	TARGET(EQL)
+		COMPARISON(==, obj_eql);
+	TARGET(NEQ)
+		COMPARISON(!=, obj_neq);
+	TARGET(IN)
+		BINARY(obj_in);
+	TARGET(AND)
+		BINARY(obj_and);
+	TARGET(OR)
+		BINARY(obj_or);
+
+	TARGET(ASSIGN)
+		op2 = POP();
+		if (isImmortal(TOP())) {  /* target is a temporary shared value, never change it */
+			obj = TOP();
+			TOP() = obj_copy(obj);
+			obj_decref(obj);
+		}
+		op1 = TOP();
+		if (OPERAND(instr) == 0) {
+			if (TYPE(op1) == INT_T && TYPE(op2) == INT_T)
+				IVAL(op1) = IVAL(op2);
+			else if (TYPE(op1) == FLOAT_T && TYPE(op2) == FLOAT_T)
+				FVAL(op1) = FVAL(op2);
+			else
+				obj_assign(op1, op2);
+		} else if (assign_number(OPERAND(instr), op1, op2) == false) {
+			result = operation(OPERAND(instr), op1, op2);
+			obj_assign(op1, result);
+			obj_decref(result);
+		}
+		obj_decref(op2);
+		DISPATCH();
+
+	TARGET(POP)
+		obj = POP();
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(JUMP)
+		pc = code->instr + OPERAND(instr);
+		DISPATCH();
+
+	TARGET(JUMP_IF_FALSE)
+		obj = POP();
+		if (TYPE(obj) == INT_T ? IVAL(obj) == 0 : obj_as_bool(obj) == false)
+			pc = code->instr + OPERAND(instr);
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(FOR_NAME)
+		if ((id = VARIABLE(OPERAND(instr)))->object == NULL)
+			scope.bind(DECLARE(OPERAND(instr)), obj_alloc(NONE_T));
+		DISPATCH();
+
+	TARGET(FOR_PREP)
+		/* the number of lines of a lines object is not known in advance,
+		 * length -1 makes FOR_NEXT continue until all lines were read */
+		result = inttype.value(isLines(TOP()) ? -1 : obj_length(TOP()));
+		PUSH(result);  /* length */
+		PUSH(obj_create(INT_T, (int_t)0));  /* counter, a new object as it is changed in place */
+		DISPATCH();
+
+	TARGET(FOR_NEXT)
+		/* stack: sequence, length, counter */
+		if (((IntObject *)sp[-1])->ival < ((IntObject *)sp[-2])->ival || ((IntObject *)sp[-2])->ival < 0) {
+			if ((obj = obj_item(sp[-3], ((IntObject *)sp[-1])->ival++)) != NULL)
+				PUSH(obj);
+			else if (isLines(sp[-3]))  /* all lines were read */
+				pc = code->instr + OPERAND(instr);
+			else
+				error(IndexError);
+		} else
+			pc = code->instr + OPERAND(instr);
+		DISPATCH();
+
+	TARGET(FOR_END)
+		for (int i = 0; i < 3; i++) {
+			obj = POP();
+			obj_decref(obj);
+		}
+		DISPATCH();
+
+	TARGET(BIND)
+		/* bind() has implicit unbind of previous value */
+		scope.bind(VARIABLE(OPERAND(instr)), POP());
+		DISPATCH();
+
+	TARGET(DECLARE)
+		if ((id = DECLARE(OPERAND(instr) & 0xFFFF))->object != NULL)
+			error(NameError, "identifier %s already declared", id->name);
+		scope.bind(id, obj_alloc((objecttype_t)(OPERAND(instr) >> 16)));
+		DISPATCH();
+
+	TARGET(FUNCTION)
+		obj = code->constant[OPERAND(instr)];
+		index = scope.slot(((PositionObject *)obj)->code->name);
+		if ((id = &scope.global[index])->object != NULL)
+			error(NameError, "%s is allready declared", id->name);
+		obj_incref(obj);
+		scope.bind(id, obj);
+		DISPATCH();
+
+	TARGET(BIND_ARG)
+		/* not all arguments have to be read from the list */
+		if ((id = &local[OPERAND(instr)])->object != NULL)
+			error(NameError, "identifier %s already declared", NAME());
+		if (f->bound == f->argc)
+			error(SyntaxError, "no argument on stack to assign to %s", NAME());
+		scope.bind(id, argument(&values[f->args + f->bound++]));
+		DISPATCH();
+
+	TARGET(PRINT)
+		obj = POP();
+		debug_printf(~NODEBUG, "\nprint :%c", ' ');
+		#ifdef VT100
+		debug_printf(~NODEBUG, "%c[042m", 27);  /* VT100 green background */
+		#endif  /* VT100 */
+
+		if (OPERAND(instr))
+			output_char(' ');
+
+		obj_print(obj);
+
+		#ifdef VT100
+		debug_printf(~NODEBUG, "%c[0m", 27);  /* VT100 standard background */
+		#endif  /* VT100 */
+
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(PRINT_NEWLINE)
+		output_char('\n');
+		DISPATCH();
+
+	TARGET(PROMPT)
+		obj_print(code->constant[OPERAND(instr)]);
+		output_flush();
+		DISPATCH();
+
+	TARGET(INPUT)
+		if ((id = VARIABLE(OPERAND(instr)))->object == NULL)
+			error(NameError, "identifier %s undeclared", NAME());
+		scope.bind(id, obj_scan(TYPE(id->object)));
+		DISPATCH();
+
+	TARGET(IMPORT)
+		obj = POP();
+		f->sp = sp - values;
+		vm_locate();  /* an error while loading the module is reported at the import */
+		frame = NULL;  /* errors are now reported by the reader */
+		reader.import(obj_as_str(obj));
+		f = &frames[depth - 1];  /* the arrays may have moved */
+		LOAD_FRAME();
+		sp = &values[f->sp];
+		obj_decref(obj);
+		DISPATCH();
+
+	TARGET(RETURN)
+		result = POP();
+		while (sp > stack) {  /* release the loop administration (if any) */
+			obj = POP();
+			obj_decref(obj);
+		}
+		for (int i = 0; i < code->nlocals; i++)
+			scope.unbind(&local[i]);
+		for (int i = f->bound; i < f->argc; i++)  /* arguments without parameter */
+			obj_decref(values[f->args + i]);
+		if (profiling)
+			profile_leave();
+		if (--depth == entry) {
+			frame = depth ? &frames[depth - 1] : NULL;
+			return result;
+		}
+		debug_printf(DEBUGBLOCK, "\n------: %s", "End function");
+		f = &frames[depth - 1];  /* return to caller */
+		LOAD_FRAME();
+		sp = &values[f->sp];
+		pc = f->pc + 1;
+		PUSH(result);
+		DISPATCH();
+
+	#ifndef COMPUTED_GOTO
+			default:
+				error(SystemError, "unknown opcode %d", OPCODE(instr));
+			}
+		}
+	#endif  /* COMPUTED_GOTO */
+
+	return NULL;
+}
+
+
+/* Execute the code of a module.
+ *
+ * m			module to execute
+ * return		0 or integer return value argument from return statement
+ */
+int execute(Module *m)
+{
+	Object *obj;
+	int r = 0;
+
+	debug_printf(DEBUGBLOCK, "\n------: %s %s", "Start execution", m->name);
+
+	obj = run(m->bytecode);
+
+	if (isNumber(obj))
+		r = obj_as_int(obj);
+	obj_decref(obj);
+
+	return r;
+}
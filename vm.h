@@ -0,0 +1,15 @@
+/* vm.h
+ *
+ * 2020	K.W.E. de Lange
+ */
+#ifndef _VM_
+#define _VM_
+
+#include "module.h"
+#include "code.h"
+
+extern int execute(Module *m);
+extern void vm_locate(void);
+extern Code *vm_current(int *index);
+
+#endif